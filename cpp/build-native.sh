@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# ============================================================================
+# RayTracerStudio - Native Build Script
+# ============================================================================
+
+set -e
+
+CXX="${CXX:-c++}"
+
+if ! command -v "$CXX" &> /dev/null; then
+    echo "$CXX not found. Set CXX to a C++17 compiler (g++ or clang++)."
+    exit 1
+fi
+
+echo "🔧 Building RayTracerStudio native renderer..."
+
+# Get the directory where this script is located
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+# Input and output paths
+INPUT_FILE="$SCRIPT_DIR/cli.cpp"
+OUTPUT_DIR="$SCRIPT_DIR/build"
+OUTPUT_NAME="raytracer"
+
+# Create output directory if it doesn't exist
+mkdir -p "$OUTPUT_DIR"
+
+CXX_FLAGS=(-I"$SCRIPT_DIR/include" -std=c++17 -O3 -pthread)
+
+# PGO=1: build instrumented, train on the preset benchmark, then rebuild
+# over the same output path (GCC names its profile after it)
+# with the profile. With clang the merged profile is also picked up by
+# build.sh for the WebAssembly speed variants.
+if [ "${PGO:-0}" = "1" ]; then
+    PGO_DIR="$OUTPUT_DIR/pgo"
+    rm -rf "$PGO_DIR"
+    mkdir -p "$PGO_DIR"
+
+    if "$CXX" --version | grep -q clang; then
+        GENERATE_FLAGS=(-fprofile-instr-generate)
+        USE_FLAGS=(-fprofile-instr-use="$PGO_DIR/raytracer.profdata")
+    else
+        GENERATE_FLAGS=(-fprofile-generate -fprofile-dir="$PGO_DIR")
+        USE_FLAGS=(-fprofile-use -fprofile-dir="$PGO_DIR" -fprofile-correction)
+    fi
+
+    echo "   Training on the preset benchmark..."
+    "$CXX" "$INPUT_FILE" "${CXX_FLAGS[@]}" "${GENERATE_FLAGS[@]}" -o "$OUTPUT_DIR/$OUTPUT_NAME"
+    for preset in 0 1 2 3 4 5; do
+        for soft in 0 4; do
+            LLVM_PROFILE_FILE="$PGO_DIR/train-%p.profraw" \
+                "$OUTPUT_DIR/$OUTPUT_NAME" --preset "$preset" --soft "$soft" \
+                --size 256x256 --bench 2 -o "$PGO_DIR/train" > /dev/null
+        done
+    done
+    # Scenes the presets don't cover (e.g. 8+ spheres, which use the wide
+    # kernels) can be added to the training set
+    for scene in ${PGO_SCENES:-}; do
+        LLVM_PROFILE_FILE="$PGO_DIR/train-%p.profraw" \
+            "$OUTPUT_DIR/$OUTPUT_NAME" --scene "$scene" --size 256x256 --bench 2 \
+            -o "$PGO_DIR/train" > /dev/null
+    done
+
+    if "$CXX" --version | grep -q clang; then
+        llvm-profdata merge -o "$PGO_DIR/raytracer.profdata" "$PGO_DIR"/*.profraw
+    fi
+    CXX_FLAGS+=("${USE_FLAGS[@]}")
+fi
+
+"$CXX" "$INPUT_FILE" "${CXX_FLAGS[@]}" -o "$OUTPUT_DIR/$OUTPUT_NAME"
+
+echo "✅ Build complete!"
+echo "   Output: $OUTPUT_DIR/$OUTPUT_NAME"
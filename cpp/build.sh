@@ -32,20 +32,74 @@ OUTPUT_NAME="raytracer"
 # Create output directory if it doesn't exist
 mkdir -p "$OUTPUT_DIR"
 
-# Compile with Emscripten
-emcc "$INPUT_FILE" \
-    -I"$SCRIPT_DIR/include" \
-    -O3 \
-    -s WASM=1 \
-    -s MODULARIZE=1 \
-    -s EXPORT_ES6=1 \
-    -s ALLOW_MEMORY_GROWTH=1 \
-    -s ENVIRONMENT='web' \
-    -s EXPORT_NAME='createRaytracerModule' \
-    --bind \
-    -o "$OUTPUT_DIR/$OUTPUT_NAME.js"
+# Variants to build (space separated); the frontend loader picks the best
+# one the browser supports and falls back to the baseline module
+#   baseline  -O3 + LTO, runs everywhere       -> raytracer.js
+#   simd      baseline + WebAssembly SIMD128   -> raytracer-simd.js
+#   small     -Oz, no exceptions/RTTI, no FS   -> raytracer-small.js
+VARIANTS="${VARIANTS:-baseline simd small}"
 
-echo "✅ Build complete!"
-echo "   Output: $OUTPUT_DIR/$OUTPUT_NAME.js"
-echo "   Output: $OUTPUT_DIR/$OUTPUT_NAME.wasm"
+# Profile from the native preset benchmark (CXX=clang++ PGO=1 ./build-native.sh)
+# emcc shares clang's front end, so the speed variants can reuse it
+PGO_PROFILE="${PGO_PROFILE:-$SCRIPT_DIR/build/pgo/raytracer.profdata}"
+PGO_FLAGS=""
+if [ -f "$PGO_PROFILE" ]; then
+    PGO_FLAGS="-fprofile-instr-use=$PGO_PROFILE -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date"
+    echo "   Using profile: $PGO_PROFILE"
+fi
+
+# Fixed heap, so JS views into WASM memory are never detached by growth. The
+# render arena for a 1024x1024 frame takes 76 MB; the rest holds scenes/meshes
+HEAP_MB="${HEAP_MB:-256}"
+
+# Generate the embind glue for every bound function at build time instead of
+# with new Function() while the module starts (emsdk 3.1.52+)
+EMBIND_FLAGS=""
+EMCC_VERSION="$(emcc -dumpversion)"
+if [ "$(printf '%s\n' 3.1.52 "$EMCC_VERSION" | sort -V | head -n 1)" = "3.1.52" ]; then
+    EMBIND_FLAGS="-s EMBIND_AOT=1"
+else
+    echo "   emcc $EMCC_VERSION: embind glue is built at startup (3.1.52+ builds it ahead of time)"
+fi
 
+COMMON_FLAGS=(
+    -I"$SCRIPT_DIR/include"
+    -flto
+    -s WASM=1
+    -s MODULARIZE=1
+    -s EXPORT_ES6=1
+    -s INITIAL_MEMORY="${HEAP_MB}MB"
+    -s ALLOW_MEMORY_GROWTH=0
+    -s ENVIRONMENT='web'
+    -s EXPORT_NAME='createRaytracerModule'
+    --bind
+)
+
+build_variant() {
+    local name="$1"
+    shift
+    emcc "$INPUT_FILE" "${COMMON_FLAGS[@]}" $EMBIND_FLAGS "$@" -o "$OUTPUT_DIR/$name.js"
+    echo "   Output: $OUTPUT_DIR/$name.js ($(wc -c < "$OUTPUT_DIR/$name.wasm") byte wasm)"
+}
+
+for variant in $VARIANTS; do
+    case "$variant" in
+        baseline)
+            build_variant "$OUTPUT_NAME" -O3 $PGO_FLAGS
+            ;;
+        simd)
+            build_variant "$OUTPUT_NAME-simd" -O3 -msimd128 $PGO_FLAGS
+            ;;
+        small)
+            # embind needs RTTI for type names unless told not to use them
+            build_variant "$OUTPUT_NAME-small" -Oz -fno-exceptions -fno-rtti \
+                -DEMSCRIPTEN_HAS_UNBOUND_TYPE_NAMES=0 -s FILESYSTEM=0
+            ;;
+        *)
+            echo "Unknown variant: $variant (expected baseline, simd or small)"
+            exit 1
+            ;;
+    esac
+done
+
+echo "✅ Build complete!"
@@ -0,0 +1,413 @@
+/**
+ * RayTracerStudio - Native Command-Line Renderer
+ *
+ * Renders a scene preset with the same engine as the WebAssembly module
+ * and writes the beauty pass plus optional AOV layers to disk.
+ *
+ * Usage:
+ *   raytracer [options]
+ *     --preset <0-5>      Scene preset (default 0)
+ *     --scene <file>      Load a scene file (.rtsc binary or JSON)
+ *     --save-scene <file> Write the scene as binary .rtsc and exit
+ *     --obj <file>        Add a Wavefront OBJ mesh (repeatable)
+ *     --instance x,y,z    Place another copy of the last --obj mesh
+ *     --size <w>x<h>      Output resolution (default 512x512)
+ *     --aa <0-2>          Anti-aliasing level
+ *     --soft <samples>    Enable soft shadows with N samples per light
+ *     --depth <n>         Maximum bounces (1-10, default 5)
+ *     --stochastic        Follow one Fresnel-picked bounce per glass hit and end
+ *                         dim paths by Russian roulette
+ *     --accumulate <n>    Average N frames, each with fresh random numbers
+ *     --light-samples <n> Many-light mode: sample N lights per hit
+ *     --vis-cache <size>  Cache shadow factors in cells of this size
+ *     --denoise           Run the à-trous denoiser
+ *     --aovs              Also write depth/normal/albedo/ID layers
+ *     --camera x,y,z      Camera position
+ *     -o <prefix>         Output path prefix (default "render")
+ *     --bench <frames>    Time N renders of the scene instead of writing output
+ *     --progressive       Render coarse-to-fine; also writes the 1/8, 1/4 and 1/2
+ *                         previews (with --bench: time to each level)
+ *     --isa <level>       Cap the dispatched kernels at baseline, sse4.2, avx2
+ *                         or avx512 (default: the best the CPU supports)
+ *     --threads <n>       Render threads (default 0 = one per hardware thread)
+ *     --order <mode>      Pixel order within tiles: rows, morton or hilbert
+ *                         (default hilbert)
+ *     --perf              With --bench, also report hardware cache counters
+ *     --wavefront         Trace breadth-first, a level of bounces at a time
+ *     --sort-rays         With --wavefront, sort each level by direction and origin
+ *
+ * Layers are written as <prefix>.ppm (beauty) and, with --aovs,
+ * <prefix>.depth.pfm, .normal.pfm, .albedo.pfm and .id.pfm
+ * (object type, object index, material ID). --progressive adds
+ * <prefix>.s8.ppm, .s4.ppm and .s2.ppm.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <algorithm>
+
+// This file defines the counting operator new (see HeapStats.h)
+#define RT_HEAP_STATS_IMPLEMENTATION
+#include "include/HeapStats.h"
+#include "include/Scene.h"
+#include "include/SceneLoader.h"
+#include "include/ObjLoader.h"
+#include "include/Renderer.h"
+#include "include/PerfCounters.h"
+
+// ============================================================================
+// Image Writers
+// ============================================================================
+
+static bool writePPM(const std::string& path, const ArenaSpan<uint8_t>& rgba, int width, int height) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        std::fwrite(&rgba[i], 1, 3, file);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Portable float map; channels is 1 (grayscale "Pf") or 3 (color "PF")
+// PFM stores scanlines bottom-to-top, negative scale = little-endian
+template <typename Buffer>
+static bool writePFM(const std::string& path, const Buffer& data, int channels, int width, int height) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    std::fprintf(file, "%s\n%d %d\n-1.0\n", channels == 3 ? "PF" : "Pf", width, height);
+    std::vector<float> row(static_cast<size_t>(width) * channels);
+    for (int y = height - 1; y >= 0; --y) {
+        const auto* src = &data[static_cast<size_t>(y) * width * channels];
+        for (size_t i = 0; i < row.size(); ++i) {
+            row[i] = static_cast<float>(src[i]);
+        }
+        std::fwrite(row.data(), sizeof(float), row.size(), file);
+    }
+    std::fclose(file);
+    return true;
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+static const char* pixelOrderName(PixelOrder order) {
+    switch (order) {
+        case PixelOrder::ROWS: return "rows";
+        case PixelOrder::MORTON: return "morton";
+        default: return "hilbert";
+    }
+}
+
+// Render the scene repeatedly after one warm-up frame and report frame times
+// (and hardware counters of the calling thread with `perf`)
+static int runBenchmark(Scene& scene, Renderer& renderer, int frames, bool perf) {
+    using Clock = std::chrono::steady_clock;
+
+    renderer.renderFrame(scene);
+
+    PerfCounters counters;
+    bool counting = perf && counters.open();
+    if (perf && !counting) {
+        std::printf("perf counters unavailable (no PMU, or kernel.perf_event_paranoid > 2)\n");
+    }
+    if (counting) {
+        counters.start();
+    }
+
+    double total = 0.0;
+    double best = 1e30;
+    uint64_t allocations = 0;
+    for (int i = 0; i < frames; ++i) {
+        Clock::time_point start = Clock::now();
+        renderer.renderFrame(scene);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        total += ms;
+        best = std::min(best, ms);
+        allocations = std::max(allocations, renderer.frameAllocations);
+    }
+    if (counting) {
+        counters.stop();
+    }
+
+    std::printf("%dx%d, %d objects, %d frames: avg %.2f ms, best %.2f ms (%s kernels, %d threads)\n",
+                renderer.width, renderer.height, scene.getTotalObjectCount(),
+                frames, total / frames, best, cpuIsaName(cpuKernels().isa), renderer.getThreads());
+    std::printf("pixel order: %s%s\n", pixelOrderName(renderer.pixelOrder),
+                !renderer.getWavefront() ? "" : renderer.getRaySorting() ? ", wavefront (sorted)" : ", wavefront");
+
+    if (counting) {
+        std::printf("perf/frame%s:", renderer.getThreads() > 1 ? " (calling thread only)" : "");
+        for (int event = 0; event < PerfCounters::EVENT_COUNT; ++event) {
+            if (counters.available(event)) {
+                std::printf(" %s %.0f", PerfCounters::eventName(event),
+                            static_cast<double>(counters.value(event)) / frames);
+            }
+        }
+        std::printf("\n");
+    }
+
+    const ShadowStats& shadows = scene.getShadowStats();
+    std::printf("shadow rays/frame: %llu, blocked %llu, last-occluder hits %.1f%%\n",
+                static_cast<unsigned long long>(shadows.queries),
+                static_cast<unsigned long long>(shadows.occluded),
+                shadows.hitRate() * 100.0f);
+    std::printf("heap allocations/frame: %llu (arena %zu KB)\n",
+                static_cast<unsigned long long>(allocations), renderer.arena.getCapacity() / 1024);
+
+    if (scene.getVisibilityCache()) {
+        const VisibilityCache& cache = scene.visibilityCache;
+        std::printf("visibility cache: %zu cells, %.1f%% hits over all frames\n", cache.size(),
+                    100.0 * cache.hits() / std::max<uint64_t>(1, cache.hits() + cache.misses()));
+    }
+    return 0;
+}
+
+// Progressive frames: average time from the start of the frame to each level
+static int runProgressiveBenchmark(Scene& scene, Renderer& renderer, int frames) {
+    using Clock = std::chrono::steady_clock;
+    const int kLevels = 4;  // Strides 8, 4, 2, 1
+
+    renderer.renderFrame(scene);
+
+    double levelMs[kLevels] = {0.0, 0.0, 0.0, 0.0};
+    for (int i = 0; i < frames; ++i) {
+        Clock::time_point start = Clock::now();
+        renderer.beginProgressive(scene);
+        for (int level = 0; level < kLevels; ++level) {
+            renderer.renderNextLevel(scene);
+            levelMs[level] += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+    }
+
+    std::printf("%dx%d, %d objects, %d progressive frames (%s kernels, %d threads), avg ms to each level:\n",
+                renderer.width, renderer.height, scene.getTotalObjectCount(), frames,
+                cpuIsaName(cpuKernels().isa), renderer.getThreads());
+    std::printf("1/8 %.2f, 1/4 %.2f, 1/2 %.2f, full %.2f\n", levelMs[0] / frames,
+                levelMs[1] / frames, levelMs[2] / frames, levelMs[3] / frames);
+    return 0;
+}
+
+// ============================================================================
+// Entry Point
+// ============================================================================
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "Usage: raytracer [--preset N] [--scene file] [--save-scene file] [--obj file]\n"
+        "                 [--instance x,y,z] [--size WxH] [--aa N] [--soft N]\n"
+        "                 [--depth N] [--stochastic] [--accumulate frames]\n"
+        "                 [--light-samples N] [--vis-cache size]\n"
+        "                 [--denoise] [--aovs] [--camera x,y,z] [-o prefix]\n"
+        "                 [--progressive] [--bench frames] [--isa level] [--threads N]\n"
+        "                 [--order rows|morton|hilbert] [--perf] [--wavefront]\n"
+        "                 [--sort-rays]\n");
+}
+
+int main(int argc, char** argv) {
+    Scene scene;
+    Renderer renderer;
+    std::string prefix = "render";
+    const char* saveScenePath = nullptr;
+    int benchFrames = 0;
+    bool progressive = false;
+    int threads = 0;
+    bool perf = false;
+    int accumulateFrames = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(arg, "--preset") == 0 && value) {
+            scene.loadPreset(static_cast<ScenePreset>(std::atoi(value)));
+            ++i;
+        } else if (std::strcmp(arg, "--scene") == 0 && value) {
+            std::string error;
+            if (!SceneFile::loadFile(scene, value, &error)) {
+                std::fprintf(stderr, "%s: %s\n", value, error.c_str());
+                return 1;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--obj") == 0 && value) {
+            Mesh mesh;
+            std::string error;
+            if (!ObjFile::loadFile(mesh, value, &error)) {
+                std::fprintf(stderr, "%s: %s\n", value, error.c_str());
+                return 1;
+            }
+            mesh.materialId = scene.addMaterial(Material(Vec3(0.8f, 0.8f, 0.8f), 0.4f, 32.0f));
+            scene.addInstance(scene.addMesh(std::move(mesh)), Transform());
+            ++i;
+        } else if (std::strcmp(arg, "--instance") == 0 && value) {
+            float x, y, z;
+            if (scene.meshes.empty() || std::sscanf(value, "%f,%f,%f", &x, &y, &z) != 3) {
+                printUsage();
+                return 1;
+            }
+            scene.addInstance(scene.getMeshCount() - 1, Transform::translate(Vec3(x, y, z)));
+            ++i;
+        } else if (std::strcmp(arg, "--save-scene") == 0 && value) {
+            saveScenePath = value;
+            ++i;
+        } else if (std::strcmp(arg, "--size") == 0 && value) {
+            if (std::sscanf(value, "%dx%d", &renderer.width, &renderer.height) != 2) {
+                printUsage();
+                return 1;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--aa") == 0 && value) {
+            renderer.setAntiAliasing(std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--soft") == 0 && value) {
+            scene.setSoftShadows(true);
+            scene.setShadowSamples(std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--depth") == 0 && value) {
+            scene.setMaxReflectionDepth(std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--stochastic") == 0) {
+            scene.setStochasticBounces(true);
+        } else if (std::strcmp(arg, "--accumulate") == 0 && value) {
+            accumulateFrames = std::max(1, std::atoi(value));
+            renderer.setAccumulation(true);
+            ++i;
+        } else if (std::strcmp(arg, "--light-samples") == 0 && value) {
+            scene.setLightSamples(std::atoi(value));
+            ++i;
+        } else if (std::strcmp(arg, "--vis-cache") == 0 && value) {
+            scene.setVisibilityCache(true);
+            scene.setVisibilityCacheCellSize(static_cast<float>(std::atof(value)));
+            ++i;
+        } else if (std::strcmp(arg, "--denoise") == 0) {
+            renderer.setDenoise(true);
+        } else if (std::strcmp(arg, "--aovs") == 0) {
+            renderer.setAOVs(true);
+        } else if (std::strcmp(arg, "--camera") == 0 && value) {
+            float x, y, z;
+            if (std::sscanf(value, "%f,%f,%f", &x, &y, &z) != 3) {
+                printUsage();
+                return 1;
+            }
+            scene.updateCamera(x, y, z);
+            ++i;
+        } else if (std::strcmp(arg, "--progressive") == 0) {
+            progressive = true;
+        } else if (std::strcmp(arg, "--bench") == 0 && value) {
+            benchFrames = std::atoi(value);
+            ++i;
+        } else if (std::strcmp(arg, "--isa") == 0 && value) {
+            CpuIsa isa;
+            if (!parseCpuIsa(value, isa)) {
+                printUsage();
+                return 1;
+            }
+            if (!selectCpuKernels(isa)) {
+                std::fprintf(stderr, "This CPU does not support %s (best: %s)\n", value, cpuIsaName(detectCpuIsa()));
+                return 1;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--order") == 0 && value) {
+            if (std::strcmp(value, "rows") == 0) {
+                renderer.setPixelOrder(static_cast<int>(PixelOrder::ROWS));
+            } else if (std::strcmp(value, "morton") == 0) {
+                renderer.setPixelOrder(static_cast<int>(PixelOrder::MORTON));
+            } else if (std::strcmp(value, "hilbert") == 0) {
+                renderer.setPixelOrder(static_cast<int>(PixelOrder::HILBERT));
+            } else {
+                printUsage();
+                return 1;
+            }
+            ++i;
+        } else if (std::strcmp(arg, "--wavefront") == 0) {
+            renderer.setWavefront(true);
+        } else if (std::strcmp(arg, "--sort-rays") == 0) {
+            renderer.setRaySorting(true);
+        } else if (std::strcmp(arg, "--perf") == 0) {
+            perf = true;
+        } else if (std::strcmp(arg, "--threads") == 0 && value) {
+            threads = std::atoi(value);
+            ++i;
+        } else if (std::strcmp(arg, "-o") == 0 && value) {
+            prefix = value;
+            ++i;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (saveScenePath) {
+        if (!SceneFile::saveFile(scene, saveScenePath)) {
+            std::fprintf(stderr, "Failed to write scene '%s'\n", saveScenePath);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (renderer.width <= 0 || renderer.height <= 0) {
+        printUsage();
+        return 1;
+    }
+
+    renderer.setMaxResolution(renderer.width, renderer.height);
+    renderer.setThreads(threads);
+
+    if (benchFrames > 0) {
+        return progressive ? runProgressiveBenchmark(scene, renderer, benchFrames)
+                           : runBenchmark(scene, renderer, benchFrames, perf);
+    }
+
+    int width = renderer.width;
+    int height = renderer.height;
+    bool ok = true;
+
+    if (progressive) {
+        renderer.beginProgressive(scene);
+        while (renderer.renderNextLevel(scene)) {
+            std::string level = ".s" + std::to_string(renderer.getProgressiveStride()) + ".ppm";
+            ok = writePPM(prefix + level, renderer.framebuffer, width, height) && ok;
+        }
+    } else {
+        renderer.renderFrame(scene);
+    }
+    // Further frames for --accumulate (the first one may have been progressive)
+    for (int frame = 1; frame < accumulateFrames; ++frame) {
+        renderer.renderFrame(scene);
+    }
+
+    ok = writePPM(prefix + ".ppm", renderer.framebuffer, width, height) && ok;
+
+    if (renderer.getAOVs()) {
+        const GBuffer& g = renderer.gbuffer;
+        ok = writePFM(prefix + ".depth.pfm", g.depth, 1, width, height) && ok;
+        ok = writePFM(prefix + ".normal.pfm", g.normal, 3, width, height) && ok;
+        ok = writePFM(prefix + ".albedo.pfm", g.albedo, 3, width, height) && ok;
+
+        // Packed object IDs don't fit a float mantissa, so IDs are unpacked into
+        // one RGB layer: R = object type, G = object index, B = material ID
+        std::vector<float> ids(static_cast<size_t>(width) * height * 3);
+        for (size_t i = 0; i < g.objectId.size(); ++i) {
+            ids[i * 3 + 0] = static_cast<float>(GBuffer::objectIdType(g.objectId[i]));
+            ids[i * 3 + 1] = static_cast<float>(GBuffer::objectIdIndex(g.objectId[i]));
+            ids[i * 3 + 2] = static_cast<float>(g.materialId[i]);
+        }
+        ok = writePFM(prefix + ".id.pfm", ids, 3, width, height) && ok;
+    }
+
+    if (!ok) {
+        std::fprintf(stderr, "Failed to write output with prefix '%s'\n", prefix.c_str());
+        return 1;
+    }
+
+    return 0;
+}
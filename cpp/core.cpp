@@ -6,8 +6,14 @@
  */
 
 #include <emscripten/bind.h>
+#include <emscripten/val.h>
 #include <vector>
 #include <cstdint>
+#include <string>
+
+// This file defines the counting operator new (see HeapStats.h)
+#define RT_HEAP_STATS_IMPLEMENTATION
+#include "include/HeapStats.h"
 
 #include "include/Vec3.h"
 #include "include/Ray.h"
@@ -18,24 +24,143 @@
 #include "include/Box.h"
 #include "include/Cylinder.h"
 #include "include/Plane.h"
+#include "include/Mesh.h"
+#include "include/Transform.h"
+#include "include/Instance.h"
 #include "include/Scene.h"
+#include "include/SceneLoader.h"
+#include "include/ObjLoader.h"
+#include "include/GBuffer.h"
+#include "include/Denoiser.h"
 #include "include/Renderer.h"
 
 // ============================================================================
 // Global Instances
 // ============================================================================
 
-Scene globalScene;
-Renderer globalRenderer;
+// Built on first use rather than by global constructors, so instantiating
+// the module runs no engine code before JS asks for something
+Scene& globalScene() {
+    static Scene scene;
+    return scene;
+}
+
+Renderer& globalRenderer() {
+    static Renderer renderer;
+    return renderer;
+}
 
 // ============================================================================
 // Render API
 // ============================================================================
 
+// Copies the frame into a new vector; renderFrame() avoids the copy
 std::vector<uint8_t> render(int width, int height) {
-    globalRenderer.width = width;
-    globalRenderer.height = height;
-    return globalRenderer.render(globalScene);
+    globalRenderer().width = width;
+    globalRenderer().height = height;
+    return globalRenderer().render(globalScene());
+}
+
+// Render into the preallocated arena and return a zero-copy Uint8Array view
+// of the RGBA pixels, valid until the next frame
+emscripten::val renderFrame(int width, int height) {
+    globalRenderer().width = width;
+    globalRenderer().height = height;
+    const ArenaSpan<uint8_t>& pixels = globalRenderer().renderFrame(globalScene());
+    return emscripten::val(emscripten::typed_memory_view(pixels.size(), pixels.data()));
+}
+
+// Start a coarse-to-fine frame; renderNextLevel() then refines it
+void beginProgressiveFrame(int width, int height) {
+    globalRenderer().width = width;
+    globalRenderer().height = height;
+    globalRenderer().beginProgressive(globalScene());
+}
+
+// Trace the next level and return a view of the whole frame (coarse levels
+// are block filled); getProgressiveStride() is 1 once it is final
+emscripten::val renderNextLevel() {
+    globalRenderer().renderNextLevel(globalScene());
+    const ArenaSpan<uint8_t>& pixels = globalRenderer().framebuffer;
+    return emscripten::val(emscripten::typed_memory_view(pixels.size(), pixels.data()));
+}
+
+// Block size of the last level drawn (8, 4, 2, then 1 for the final frame)
+int getProgressiveStride() {
+    return globalRenderer().getProgressiveStride();
+}
+
+// Render threads (0 = one per hardware thread); 1 unless built with -pthread
+void setThreads(int count) {
+    globalRenderer().setThreads(count);
+}
+
+int getThreads() {
+    return globalRenderer().getThreads();
+}
+
+// Pixel order within tiles: 0 = rows, 1 = Morton, 2 = Hilbert (default)
+void setPixelOrder(int order) {
+    globalRenderer().setPixelOrder(order);
+}
+
+int getPixelOrder() {
+    return globalRenderer().getPixelOrder();
+}
+
+// Breadth-first tracing, optionally with sorted bounce queues
+void setWavefront(bool enabled) {
+    globalRenderer().setWavefront(enabled);
+}
+
+bool getWavefront() {
+    return globalRenderer().getWavefront();
+}
+
+void setRaySorting(bool enabled) {
+    globalRenderer().setRaySorting(enabled);
+}
+
+bool getRaySorting() {
+    return globalRenderer().getRaySorting();
+}
+
+// Average successive frames; reset after any scene or setting change
+void setAccumulation(bool enabled) {
+    globalRenderer().setAccumulation(enabled);
+}
+
+bool getAccumulation() {
+    return globalRenderer().getAccumulation();
+}
+
+void resetAccumulation() {
+    globalRenderer().resetAccumulation();
+}
+
+int getAccumulatedFrames() {
+    return globalRenderer().getAccumulatedFrames();
+}
+
+// Size the render arena for the largest frame up front, so frames at or
+// below it allocate nothing
+bool setMaxResolution(int width, int height) {
+    return globalRenderer().setMaxResolution(width, height);
+}
+
+// Diagnostics of the last frame, read in one call
+struct FrameStats {
+    double allocations;        // Heap allocations (0 in steady state)
+    double arenaBytes;
+    float shadowCacheHitRate;  // Blocked shadow rays the last-occluder hint resolved
+};
+
+FrameStats getFrameStats() {
+    FrameStats stats;
+    stats.allocations = static_cast<double>(globalRenderer().frameAllocations);
+    stats.arenaBytes = static_cast<double>(globalRenderer().arena.getCapacity());
+    stats.shadowCacheHitRate = globalScene().getShadowStats().hitRate();
+    return stats;
 }
 
 // ============================================================================
@@ -43,23 +168,107 @@ std::vector<uint8_t> render(int width, int height) {
 // ============================================================================
 
 void loadScenePreset(int preset) {
-    globalScene.loadPreset(static_cast<ScenePreset>(preset));
+    globalScene().loadPreset(static_cast<ScenePreset>(preset));
+}
+
+std::string sceneLoadError;
+
+// Load a scene file (binary .rtsc or JSON) passed from JS as a Uint8Array,
+// ArrayBuffer or string. Returns false and sets getSceneLoadError() on failure.
+bool loadScene(const std::string& data) {
+    sceneLoadError.clear();
+    return SceneFile::load(globalScene(), reinterpret_cast<const uint8_t*>(data.data()), data.size(), &sceneLoadError);
+}
+
+std::string getSceneLoadError() {
+    return sceneLoadError;
+}
+
+// Load an OBJ mesh (Uint8Array or string) with a default grey material and
+// place one instance of it at the origin. Returns the mesh index for
+// addInstance(), or -1 and sets getSceneLoadError().
+int loadMesh(const std::string& data) {
+    sceneLoadError.clear();
+    Mesh mesh;
+    if (!ObjFile::load(mesh, reinterpret_cast<const uint8_t*>(data.data()), data.size(), &sceneLoadError)) {
+        return -1;
+    }
+    Material mat(Vec3(0.8f, 0.8f, 0.8f), 0.4f, 32.0f);
+    mesh.materialId = globalScene().addMaterial(mat);
+    int meshIndex = globalScene().addMesh(std::move(mesh));
+    globalScene().addInstance(meshIndex, Transform());
+    return meshIndex;
+}
+
+// Place another copy of a loaded mesh; returns the instance index or -1
+int addInstance(int meshIndex, float x, float y, float z) {
+    return globalScene().addInstance(meshIndex, Transform::translate(Vec3(x, y, z)));
+}
+
+void removeInstance(int index) {
+    globalScene().removeInstance(index);
+}
+
+// Rotation is in degrees (applied Z, X, then Y); scale is per axis
+void setInstanceTransform(int index, float x, float y, float z,
+                          float rx, float ry, float rz,
+                          float sx, float sy, float sz) {
+    globalScene().setInstanceTransform(index, Transform::fromTRS(Vec3(x, y, z), Vec3(rx, ry, rz), Vec3(sx, sy, sz)));
+}
+
+// Override an instance's color (other properties come from its mesh's material)
+void setInstanceColor(int index, float r, float g, float b) {
+    if (index < 0 || index >= globalScene().getInstanceCount()) {
+        return;
+    }
+    const Instance& inst = globalScene().instances[index];
+    Material mat = globalScene().materials[globalScene().meshes[inst.meshIndex].materialId];
+    mat.color = Vec3(r, g, b);
+    globalScene().setInstanceMaterial(index, globalScene().addMaterial(mat));
+}
+
+int getInstanceCount() {
+    return globalScene().getInstanceCount();
+}
+
+void clearMeshes() {
+    globalScene().clearMeshes();
+}
+
+int getMeshCount() {
+    return globalScene().getMeshCount();
+}
+
+int getTriangleCount() {
+    return globalScene().getTriangleCount();
+}
+
+void setBoxRotation(int index, float rx, float ry, float rz) {
+    globalScene().setBoxRotation(index, rx, ry, rz);
+}
+
+void setCylinderRotation(int index, float rx, float ry, float rz) {
+    globalScene().setCylinderRotation(index, rx, ry, rz);
 }
 
 int getSphereCount() {
-    return globalScene.getSphereCount();
+    return globalScene().getSphereCount();
 }
 
 int getBoxCount() {
-    return globalScene.getBoxCount();
+    return globalScene().getBoxCount();
 }
 
 int getCylinderCount() {
-    return globalScene.getCylinderCount();
+    return globalScene().getCylinderCount();
 }
 
 int getTotalObjectCount() {
-    return globalScene.getTotalObjectCount();
+    return globalScene().getTotalObjectCount();
+}
+
+int getMaterialCount() {
+    return globalScene().getMaterialCount();
 }
 
 // ============================================================================
@@ -67,43 +276,73 @@ int getTotalObjectCount() {
 // ============================================================================
 
 void updateLight(float x, float y, float z) {
-    globalScene.updateLight(x, y, z);
+    globalScene().updateLight(x, y, z);
 }
 
 int addLight(float x, float y, float z, float r, float g, float b, float intensity) {
-    return globalScene.addLight(x, y, z, r, g, b, intensity);
+    return globalScene().addLight(x, y, z, r, g, b, intensity);
 }
 
 void removeLight(int index) {
-    globalScene.removeLight(index);
+    globalScene().removeLight(index);
 }
 
 void setLightPosition(int index, float x, float y, float z) {
-    globalScene.setLightPosition(index, x, y, z);
+    globalScene().setLightPosition(index, x, y, z);
 }
 
 void setLightColor(int index, float r, float g, float b) {
-    globalScene.setLightColor(index, r, g, b);
+    globalScene().setLightColor(index, r, g, b);
 }
 
 void setLightIntensity(int index, float intensity) {
-    globalScene.setLightIntensity(index, intensity);
+    globalScene().setLightIntensity(index, intensity);
 }
 
 int getLightCount() {
-    return globalScene.getLightCount();
+    return globalScene().getLightCount();
+}
+
+// Every property of one light in a single call; zeroed for a bad index
+struct LightInfo {
+    float x, y, z;
+    float r, g, b;
+    float intensity;
+    float radius;
+    float range;
+    int type;  // 0 = point, 1 = directional, 2 = spot
+    float directionX, directionY, directionZ;
+    float spotAngle;
+    float spotSoftness;
+};
+
+LightInfo getLight(int index) {
+    LightInfo info = {};
+    const Scene& scene = globalScene();
+    if (index < 0 || index >= scene.getLightCount()) {
+        return info;
+    }
+    const Light& light = scene.lights[index];
+    info.x = light.position.x;
+    info.y = light.position.y;
+    info.z = light.position.z;
+    info.r = light.color.x;
+    info.g = light.color.y;
+    info.b = light.color.z;
+    info.intensity = light.intensity;
+    info.radius = light.radius;
+    info.range = light.range;
+    info.type = static_cast<int>(light.type);
+    info.directionX = light.direction.x;
+    info.directionY = light.direction.y;
+    info.directionZ = light.direction.z;
+    info.spotAngle = light.spotAngle;
+    info.spotSoftness = light.spotSoftness;
+    return info;
 }
 
-float getLightX(int index) { return globalScene.getLightX(index); }
-float getLightY(int index) { return globalScene.getLightY(index); }
-float getLightZ(int index) { return globalScene.getLightZ(index); }
-float getLightR(int index) { return globalScene.getLightR(index); }
-float getLightG(int index) { return globalScene.getLightG(index); }
-float getLightB(int index) { return globalScene.getLightB(index); }
-float getLightIntensity(int index) { return globalScene.getLightIntensity(index); }
-
 void resetLights() {
-    globalScene.resetLights();
+    globalScene().resetLights();
 }
 
 // ============================================================================
@@ -111,27 +350,27 @@ void resetLights() {
 // ============================================================================
 
 void updateMaterial(float specular, float shininess, float reflectivity) {
-    globalScene.updateMainSphere(specular, shininess, reflectivity);
+    globalScene().updateMainSphere(specular, shininess, reflectivity);
 }
 
 void updateSphereColor(float r, float g, float b) {
-    globalScene.updateSphereColor(r, g, b);
+    globalScene().updateSphereColor(r, g, b);
 }
 
 void updateGroundReflectivity(float reflectivity) {
-    globalScene.updateGroundReflectivity(reflectivity);
+    globalScene().updateGroundReflectivity(reflectivity);
 }
 
 void updateMaterialTransparency(float transparency, float refractiveIndex) {
-    globalScene.updateMainSphereTransparency(transparency, refractiveIndex);
+    globalScene().updateMainSphereTransparency(transparency, refractiveIndex);
 }
 
 float getMaterialTransparency() {
-    return globalScene.getMainSphereTransparency();
+    return globalScene().getMainSphereTransparency();
 }
 
 float getMaterialRefractiveIndex() {
-    return globalScene.getMainSphereRefractiveIndex();
+    return globalScene().getMainSphereRefractiveIndex();
 }
 
 // ============================================================================
@@ -139,52 +378,52 @@ float getMaterialRefractiveIndex() {
 // ============================================================================
 
 void updateCamera(float posX, float posY, float posZ) {
-    globalScene.updateCamera(posX, posY, posZ);
+    globalScene().updateCamera(posX, posY, posZ);
 }
 
 void orbitCamera(float deltaX, float deltaY) {
-    globalScene.orbitCamera(deltaX, deltaY);
+    globalScene().orbitCamera(deltaX, deltaY);
 }
 
 void zoomCamera(float delta) {
-    globalScene.zoomCamera(delta);
+    globalScene().zoomCamera(delta);
 }
 
-float getCameraX() { return globalScene.camera.position.x; }
-float getCameraY() { return globalScene.camera.position.y; }
-float getCameraZ() { return globalScene.camera.position.z; }
+float getCameraX() { return globalScene().camera.position.x; }
+float getCameraY() { return globalScene().camera.position.y; }
+float getCameraZ() { return globalScene().camera.position.z; }
 
 void setCameraFov(float fov) {
-    globalScene.setCameraFov(fov);
+    globalScene().setCameraFov(fov);
 }
 
 void setCameraTarget(float x, float y, float z) {
-    globalScene.setCameraTarget(x, y, z);
+    globalScene().setCameraTarget(x, y, z);
 }
 
-float getCameraFov() { return globalScene.getCameraFov(); }
-float getCameraTargetX() { return globalScene.getCameraTargetX(); }
-float getCameraTargetY() { return globalScene.getCameraTargetY(); }
-float getCameraTargetZ() { return globalScene.getCameraTargetZ(); }
+float getCameraFov() { return globalScene().getCameraFov(); }
+float getCameraTargetX() { return globalScene().getCameraTargetX(); }
+float getCameraTargetY() { return globalScene().getCameraTargetY(); }
+float getCameraTargetZ() { return globalScene().getCameraTargetZ(); }
 
 // ============================================================================
 // View API
 // ============================================================================
 
 void setShowGrid(bool show) {
-    globalScene.setShowGrid(show);
+    globalScene().setShowGrid(show);
 }
 
 void setGridScale(float scale) {
-    globalScene.setGridScale(scale);
+    globalScene().setGridScale(scale);
 }
 
 void setShowGroundPlane(bool show) {
-    globalScene.setShowGroundPlane(show);
+    globalScene().setShowGroundPlane(show);
 }
 
 void setMaxReflectionDepth(int depth) {
-    globalScene.setMaxReflectionDepth(depth);
+    globalScene().setMaxReflectionDepth(depth);
 }
 
 // ============================================================================
@@ -192,15 +431,15 @@ void setMaxReflectionDepth(int depth) {
 // ============================================================================
 
 void setAntiAliasing(int level) {
-    globalRenderer.setAntiAliasing(level);
+    globalRenderer().setAntiAliasing(level);
 }
 
 int getAntiAliasing() {
-    return globalRenderer.getAntiAliasing();
+    return globalRenderer().getAntiAliasing();
 }
 
 int getSamplesPerPixel() {
-    return globalRenderer.getSamplesPerPixel();
+    return globalRenderer().getSamplesPerPixel();
 }
 
 // ============================================================================
@@ -208,27 +447,145 @@ int getSamplesPerPixel() {
 // ============================================================================
 
 void setSoftShadows(bool enabled) {
-    globalScene.setSoftShadows(enabled);
+    globalScene().setSoftShadows(enabled);
 }
 
 bool getSoftShadows() {
-    return globalScene.getSoftShadows();
+    return globalScene().getSoftShadows();
 }
 
 void setShadowSamples(int samples) {
-    globalScene.setShadowSamples(samples);
+    globalScene().setShadowSamples(samples);
 }
 
 int getShadowSamples() {
-    return globalScene.getShadowSamples();
+    return globalScene().getShadowSamples();
+}
+
+// Reuse shadow factors across frames until geometry or lights change
+void setVisibilityCache(bool enabled) {
+    globalScene().setVisibilityCache(enabled);
+}
+
+bool getVisibilityCache() {
+    return globalScene().getVisibilityCache();
+}
+
+void setVisibilityCacheCellSize(float size) {
+    globalScene().setVisibilityCacheCellSize(size);
 }
 
 void setLightRadius(int index, float radius) {
-    globalScene.setLightRadius(index, radius);
+    globalScene().setLightRadius(index, radius);
+}
+
+void setLightSamples(int samples) {
+    globalScene().setLightSamples(samples);
+}
+
+int getLightSamples() {
+    return globalScene().getLightSamples();
+}
+
+// One Fresnel-picked bounce per glass hit, Russian roulette on dim paths
+void setStochasticBounces(bool enabled) {
+    globalScene().setStochasticBounces(enabled);
+}
+
+bool getStochasticBounces() {
+    return globalScene().getStochasticBounces();
+}
+
+void setLightRange(int index, float range) {
+    globalScene().setLightRange(index, range);
+}
+
+// 0 = point, 1 = directional, 2 = spot
+void setLightType(int index, int type) {
+    globalScene().setLightType(index, type);
+}
+
+void setLightDirection(int index, float x, float y, float z) {
+    globalScene().setLightDirection(index, x, y, z);
+}
+
+void setLightSpotAngle(int index, float degrees) {
+    globalScene().setLightSpotAngle(index, degrees);
+}
+
+void setLightSpotSoftness(int index, float softness) {
+    globalScene().setLightSpotSoftness(index, softness);
+}
+
+// ============================================================================
+// Denoiser API
+// ============================================================================
+
+void setDenoise(bool enabled) {
+    globalRenderer().setDenoise(enabled);
+}
+
+bool getDenoise() {
+    return globalRenderer().getDenoise();
+}
+
+void setDenoiseIterations(int iterations) {
+    globalRenderer().setDenoiseIterations(iterations);
+}
+
+int getDenoiseIterations() {
+    return globalRenderer().getDenoiseIterations();
+}
+
+// ============================================================================
+// AOV (G-Buffer) API
+// ============================================================================
+// Buffers are zero-copy views into the render arena, valid until the next
+// frame. Copy them if they need to outlive it.
+
+void setAOVs(bool enabled) {
+    globalRenderer().setAOVs(enabled);
+}
+
+bool getAOVs() {
+    return globalRenderer().getAOVs();
 }
 
-float getLightRadius(int index) {
-    return globalScene.getLightRadius(index);
+emscripten::val getDepthBuffer() {
+    const auto& buf = globalRenderer().gbuffer.depth;
+    return emscripten::val(emscripten::typed_memory_view(buf.size(), buf.data()));
+}
+
+emscripten::val getNormalBuffer() {
+    const auto& buf = globalRenderer().gbuffer.normal;
+    return emscripten::val(emscripten::typed_memory_view(buf.size(), buf.data()));
+}
+
+emscripten::val getAlbedoBuffer() {
+    const auto& buf = globalRenderer().gbuffer.albedo;
+    return emscripten::val(emscripten::typed_memory_view(buf.size(), buf.data()));
+}
+
+emscripten::val getObjectIdBuffer() {
+    const auto& buf = globalRenderer().gbuffer.objectId;
+    return emscripten::val(emscripten::typed_memory_view(buf.size(), buf.data()));
+}
+
+emscripten::val getMaterialIdBuffer() {
+    const auto& buf = globalRenderer().gbuffer.materialId;
+    return emscripten::val(emscripten::typed_memory_view(buf.size(), buf.data()));
+}
+
+// ============================================================================
+// Picking API
+// ============================================================================
+
+// Object under pixel (x, y) of the last rendered frame
+// Answered from the object-ID buffer when AOVs are enabled and nothing moved,
+// otherwise by tracing a single ray
+PickResult pickObject(int x, int y) {
+    globalScene().updateInstances();
+    return globalRenderer().pick(globalScene(), x, y);
 }
 
 // ============================================================================
@@ -238,13 +595,49 @@ float getLightRadius(int index) {
 EMSCRIPTEN_BINDINGS(raytracer_module) {
     // Render
     emscripten::function("render", &render);
+    emscripten::function("renderFrame", &renderFrame);
+    emscripten::function("beginProgressiveFrame", &beginProgressiveFrame);
+    emscripten::function("renderNextLevel", &renderNextLevel);
+    emscripten::function("getProgressiveStride", &getProgressiveStride);
+    emscripten::function("setMaxResolution", &setMaxResolution);
+    emscripten::function("setThreads", &setThreads);
+    emscripten::function("getThreads", &getThreads);
+    emscripten::function("setPixelOrder", &setPixelOrder);
+    emscripten::function("getPixelOrder", &getPixelOrder);
+    emscripten::function("setWavefront", &setWavefront);
+    emscripten::function("getWavefront", &getWavefront);
+    emscripten::function("setRaySorting", &setRaySorting);
+    emscripten::function("getRaySorting", &getRaySorting);
+    emscripten::function("setAccumulation", &setAccumulation);
+    emscripten::function("getAccumulation", &getAccumulation);
+    emscripten::function("resetAccumulation", &resetAccumulation);
+    emscripten::function("getAccumulatedFrames", &getAccumulatedFrames);
+    emscripten::value_object<FrameStats>("FrameStats")
+        .field("allocations", &FrameStats::allocations)
+        .field("arenaBytes", &FrameStats::arenaBytes)
+        .field("shadowCacheHitRate", &FrameStats::shadowCacheHitRate);
+    emscripten::function("getFrameStats", &getFrameStats);
     
     // Scene
     emscripten::function("loadScenePreset", &loadScenePreset);
+    emscripten::function("loadScene", &loadScene);
+    emscripten::function("getSceneLoadError", &getSceneLoadError);
+    emscripten::function("loadMesh", &loadMesh);
+    emscripten::function("clearMeshes", &clearMeshes);
+    emscripten::function("addInstance", &addInstance);
+    emscripten::function("removeInstance", &removeInstance);
+    emscripten::function("setInstanceTransform", &setInstanceTransform);
+    emscripten::function("setInstanceColor", &setInstanceColor);
+    emscripten::function("getInstanceCount", &getInstanceCount);
+    emscripten::function("getMeshCount", &getMeshCount);
+    emscripten::function("getTriangleCount", &getTriangleCount);
+    emscripten::function("setBoxRotation", &setBoxRotation);
+    emscripten::function("setCylinderRotation", &setCylinderRotation);
     emscripten::function("getSphereCount", &getSphereCount);
     emscripten::function("getBoxCount", &getBoxCount);
     emscripten::function("getCylinderCount", &getCylinderCount);
     emscripten::function("getTotalObjectCount", &getTotalObjectCount);
+    emscripten::function("getMaterialCount", &getMaterialCount);
     
     // Light
     emscripten::function("updateLight", &updateLight);
@@ -254,13 +647,23 @@ EMSCRIPTEN_BINDINGS(raytracer_module) {
     emscripten::function("setLightColor", &setLightColor);
     emscripten::function("setLightIntensity", &setLightIntensity);
     emscripten::function("getLightCount", &getLightCount);
-    emscripten::function("getLightX", &getLightX);
-    emscripten::function("getLightY", &getLightY);
-    emscripten::function("getLightZ", &getLightZ);
-    emscripten::function("getLightR", &getLightR);
-    emscripten::function("getLightG", &getLightG);
-    emscripten::function("getLightB", &getLightB);
-    emscripten::function("getLightIntensity", &getLightIntensity);
+    emscripten::value_object<LightInfo>("LightInfo")
+        .field("x", &LightInfo::x)
+        .field("y", &LightInfo::y)
+        .field("z", &LightInfo::z)
+        .field("r", &LightInfo::r)
+        .field("g", &LightInfo::g)
+        .field("b", &LightInfo::b)
+        .field("intensity", &LightInfo::intensity)
+        .field("radius", &LightInfo::radius)
+        .field("range", &LightInfo::range)
+        .field("type", &LightInfo::type)
+        .field("directionX", &LightInfo::directionX)
+        .field("directionY", &LightInfo::directionY)
+        .field("directionZ", &LightInfo::directionZ)
+        .field("spotAngle", &LightInfo::spotAngle)
+        .field("spotSoftness", &LightInfo::spotSoftness);
+    emscripten::function("getLight", &getLight);
     emscripten::function("resetLights", &resetLights);
     
     // Material
@@ -301,8 +704,40 @@ EMSCRIPTEN_BINDINGS(raytracer_module) {
     emscripten::function("getSoftShadows", &getSoftShadows);
     emscripten::function("setShadowSamples", &setShadowSamples);
     emscripten::function("getShadowSamples", &getShadowSamples);
+    emscripten::function("setVisibilityCache", &setVisibilityCache);
+    emscripten::function("getVisibilityCache", &getVisibilityCache);
+    emscripten::function("setVisibilityCacheCellSize", &setVisibilityCacheCellSize);
     emscripten::function("setLightRadius", &setLightRadius);
-    emscripten::function("getLightRadius", &getLightRadius);
+    emscripten::function("setLightSamples", &setLightSamples);
+    emscripten::function("getLightSamples", &getLightSamples);
+    emscripten::function("setStochasticBounces", &setStochasticBounces);
+    emscripten::function("getStochasticBounces", &getStochasticBounces);
+    emscripten::function("setLightRange", &setLightRange);
+    emscripten::function("setLightType", &setLightType);
+    emscripten::function("setLightDirection", &setLightDirection);
+    emscripten::function("setLightSpotAngle", &setLightSpotAngle);
+    emscripten::function("setLightSpotSoftness", &setLightSpotSoftness);
+    
+    // Denoiser
+    emscripten::function("setDenoise", &setDenoise);
+    emscripten::function("getDenoise", &getDenoise);
+    emscripten::function("setDenoiseIterations", &setDenoiseIterations);
+    emscripten::function("getDenoiseIterations", &getDenoiseIterations);
+    
+    // AOVs
+    emscripten::function("setAOVs", &setAOVs);
+    emscripten::function("getAOVs", &getAOVs);
+    emscripten::function("getDepthBuffer", &getDepthBuffer);
+    emscripten::function("getNormalBuffer", &getNormalBuffer);
+    emscripten::function("getAlbedoBuffer", &getAlbedoBuffer);
+    emscripten::function("getObjectIdBuffer", &getObjectIdBuffer);
+    emscripten::function("getMaterialIdBuffer", &getMaterialIdBuffer);
+    
+    // Picking
+    emscripten::value_object<PickResult>("PickResult")
+        .field("type", &PickResult::type)
+        .field("index", &PickResult::index);
+    emscripten::function("pickObject", &pickObject);
     
     // Vector type
     emscripten::register_vector<uint8_t>("VectorUint8");
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Ray.h"
+#include <algorithm>
+#include <limits>
+
+// Axis-aligned bounds used by the acceleration structures
+// (Box is the renderable primitive; this is just min/max extents)
+struct AABB {
+    Vec3 min;
+    Vec3 max;
+
+    // Starts inverted so the first expand() sets both corners
+    AABB() : min(Vec3(1e30f, 1e30f, 1e30f)), max(Vec3(-1e30f, -1e30f, -1e30f)) {}
+    AABB(const Vec3& lo, const Vec3& hi) : min(lo), max(hi) {}
+
+    void expand(const Vec3& p) {
+        min = Vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+        max = Vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+    }
+
+    // Componentwise, so merging an empty (inverted) box is a no-op
+    void expand(const AABB& b) {
+        min = Vec3(std::min(min.x, b.min.x), std::min(min.y, b.min.y), std::min(min.z, b.min.z));
+        max = Vec3(std::max(max.x, b.max.x), std::max(max.y, b.max.y), std::max(max.z, b.max.z));
+    }
+
+    bool valid() const {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    Vec3 centroid() const {
+        return (min + max) * 0.5f;
+    }
+
+    float surfaceArea() const {
+        if (!valid()) return 0.0f;
+        Vec3 e = max - min;
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+
+    // Entry distance clipped to [0, tMax], or infinity if the box is missed
+    float intersect(const Ray& ray, float tMax) const {
+        float tNear = 0.0f;
+        float tFar = tMax;
+        if (slabs(ray, min, max, tNear, tFar)) {
+            return tNear;
+        }
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // Branchless slab test shared by Box and BVH traversal
+    // Clips [tNear, tFar] to the box; returns false if nothing is left.
+    // The ray's sign picks the near/far plane per axis, so there are no
+    // per-axis min/max swaps. Axis-parallel rays get +-inf distances; an
+    // origin exactly on such a plane gives 0 * inf = NaN, which the
+    // std::max/std::min argument order discards (they return the first
+    // argument when a comparison involves NaN).
+    static bool slabs(const Ray& ray, const Vec3& lo, const Vec3& hi, float& tNear, float& tFar) {
+        const Vec3* bounds[2] = {&lo, &hi};
+
+        float txNear = (bounds[ray.sign[0]]->x - ray.origin.x) * ray.invDirection.x;
+        float txFar = (bounds[1 - ray.sign[0]]->x - ray.origin.x) * ray.invDirection.x;
+        float tyNear = (bounds[ray.sign[1]]->y - ray.origin.y) * ray.invDirection.y;
+        float tyFar = (bounds[1 - ray.sign[1]]->y - ray.origin.y) * ray.invDirection.y;
+        float tzNear = (bounds[ray.sign[2]]->z - ray.origin.z) * ray.invDirection.z;
+        float tzFar = (bounds[1 - ray.sign[2]]->z - ray.origin.z) * ray.invDirection.z;
+
+        tNear = std::max(std::max(std::max(tNear, txNear), tyNear), tzNear);
+        tFar = std::min(std::min(std::min(tFar, txFar), tyFar), tzFar);
+        return tNear <= tFar;
+    }
+};
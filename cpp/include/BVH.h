@@ -0,0 +1,242 @@
+#pragma once
+
+#include "AABB.h"
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+
+// Bounding volume hierarchy over an arbitrary primitive list
+// Built with binned SAH; children of a node are stored next to each other
+// so an interior node only needs the index of its left child
+struct BVHNode {
+    AABB bounds;
+    uint32_t leftFirst;  // Left child index (interior) or first primitive (leaf)
+    uint32_t count;      // Primitive count; 0 for interior nodes
+
+    bool isLeaf() const { return count > 0; }
+};
+
+class BVH {
+public:
+    std::vector<BVHNode> nodes;
+
+    // Build over primitive bounds; order receives the primitive permutation
+    // (leaf ranges index into it), so callers can reorder their data to match
+    void build(const std::vector<AABB>& primBounds, std::vector<uint32_t>& order) {
+        nodes.clear();
+        uint32_t primCount = static_cast<uint32_t>(primBounds.size());
+        order.resize(primCount);
+        if (primCount == 0) return;
+
+        // Work on contiguous records so partitioning keeps them cache-friendly
+        std::vector<BuildPrim> prims(primCount);
+        for (uint32_t i = 0; i < primCount; ++i) {
+            prims[i].bounds = primBounds[i];
+            prims[i].centroid = primBounds[i].centroid();
+            prims[i].index = i;
+        }
+
+        nodes.reserve(primCount * 2 - 1);
+        nodes.push_back(BVHNode{AABB(), 0, primCount});
+
+        std::vector<uint32_t> stack;
+        stack.push_back(0);
+        while (!stack.empty()) {
+            uint32_t nodeIndex = stack.back();
+            stack.pop_back();
+
+            BVHNode& node = nodes[nodeIndex];
+            node.bounds = AABB();
+            AABB centroidBounds;
+            for (uint32_t i = 0; i < node.count; ++i) {
+                const BuildPrim& prim = prims[node.leftFirst + i];
+                node.bounds.expand(prim.bounds);
+                centroidBounds.expand(prim.centroid);
+            }
+
+            uint32_t split;
+            if (!findSplit(node, centroidBounds, prims, split)) continue;
+
+            uint32_t first = node.leftFirst;
+            uint32_t leftCount = split - first;
+            uint32_t rightCount = node.count - leftCount;
+
+            uint32_t leftIndex = static_cast<uint32_t>(nodes.size());
+            node.leftFirst = leftIndex;
+            node.count = 0;
+            // node is invalidated by the push_backs below
+            nodes.push_back(BVHNode{AABB(), first, leftCount});
+            nodes.push_back(BVHNode{AABB(), split, rightCount});
+            stack.push_back(leftIndex + 1);
+            stack.push_back(leftIndex);
+        }
+
+        for (uint32_t i = 0; i < primCount; ++i) order[i] = prims[i].index;
+    }
+
+    // Recompute node bounds after primitives moved, keeping the topology
+    // Children always follow their parent, so one backward pass suffices
+    void refit(const std::vector<AABB>& primBounds, const std::vector<uint32_t>& order) {
+        for (size_t i = nodes.size(); i-- > 0;) {
+            BVHNode& node = nodes[i];
+            node.bounds = AABB();
+            if (node.isLeaf()) {
+                for (uint32_t j = 0; j < node.count; ++j) {
+                    node.bounds.expand(primBounds[order[node.leftFirst + j]]);
+                }
+            } else {
+                node.bounds.expand(nodes[node.leftFirst].bounds);
+                node.bounds.expand(nodes[node.leftFirst + 1].bounds);
+            }
+        }
+    }
+
+    bool empty() const {
+        return nodes.empty();
+    }
+
+    const AABB& bounds() const {
+        return nodes[0].bounds;
+    }
+
+    // Walk nodes front to back, calling leaf(first, count, tMax) per leaf
+    // The callback shrinks tMax as it finds hits and returns true to stop early
+    template <typename LeafFn>
+    void traverse(const Ray& ray, float& tMax, LeafFn leaf) const {
+        if (nodes.empty()) return;
+
+        if (nodes[0].bounds.intersect(ray, tMax) > tMax) return;
+
+        uint32_t stack[64];
+        int stackSize = 0;
+        const BVHNode* node = &nodes[0];
+
+        while (true) {
+            if (node->isLeaf()) {
+                if (leaf(node->leftFirst, node->count, tMax)) return;
+                if (stackSize == 0) return;
+                node = &nodes[stack[--stackSize]];
+                continue;
+            }
+
+            // Visit the nearer child first; push the other if it is still in range
+            uint32_t near = node->leftFirst;
+            uint32_t far = near + 1;
+            float tNear = nodes[near].bounds.intersect(ray, tMax);
+            float tFar = nodes[far].bounds.intersect(ray, tMax);
+            if (tFar < tNear) {
+                std::swap(near, far);
+                std::swap(tNear, tFar);
+            }
+
+            if (tNear > tMax) {
+                if (stackSize == 0) return;
+                node = &nodes[stack[--stackSize]];
+                continue;
+            }
+
+            node = &nodes[near];
+            if (tFar <= tMax && stackSize < 64) {
+                stack[stackSize++] = far;
+            }
+        }
+    }
+
+private:
+    static constexpr int kBins = 16;
+    static constexpr uint32_t kMaxLeafSize = 4;
+    static constexpr float kTraversalCost = 1.0f;  // Relative to one primitive test
+
+    struct BuildPrim {
+        AABB bounds;
+        Vec3 centroid;
+        uint32_t index;
+    };
+
+    // Pick the cheapest binned SAH split and partition prims around it
+    // Returns false if the node should stay a leaf
+    bool findSplit(const BVHNode& node, const AABB& centroidBounds,
+                   std::vector<BuildPrim>& prims, uint32_t& split) const {
+        if (node.count <= 1) return false;
+
+        // Small nodes get fewer bins; the sweep would dominate otherwise
+        int bins = static_cast<int>(std::min<uint32_t>(kBins, std::max<uint32_t>(4, node.count)));
+
+        // Bin all three axes in a single pass over the node's primitives
+        AABB binBounds[3][kBins];
+        uint32_t binCount[3][kBins] = {};
+        float lo[3], scale[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            lo[axis] = centroidBounds.min[axis];
+            float extent = centroidBounds.max[axis] - lo[axis];
+            scale[axis] = extent > 0.0f ? bins / extent : 0.0f;
+        }
+
+        for (uint32_t i = 0; i < node.count; ++i) {
+            const BuildPrim& prim = prims[node.leftFirst + i];
+            for (int axis = 0; axis < 3; ++axis) {
+                int bin = binIndex(prim.centroid[axis], lo[axis], scale[axis], bins);
+                binCount[axis][bin]++;
+                binBounds[axis][bin].expand(prim.bounds);
+            }
+        }
+
+        float bestCost = 1e30f;
+        int bestAxis = -1;
+        int bestBin = 0;
+
+        for (int axis = 0; axis < 3; ++axis) {
+            if (scale[axis] == 0.0f) continue;
+
+            // Sweep from both ends to get the cost of each of the bins-1 planes
+            float leftArea[kBins - 1], rightArea[kBins - 1];
+            uint32_t leftCount[kBins - 1], rightCount[kBins - 1];
+            AABB leftBox, rightBox;
+            uint32_t leftSum = 0, rightSum = 0;
+            for (int i = 0; i < bins - 1; ++i) {
+                leftSum += binCount[axis][i];
+                leftCount[i] = leftSum;
+                leftBox.expand(binBounds[axis][i]);
+                leftArea[i] = leftBox.surfaceArea();
+
+                rightSum += binCount[axis][bins - 1 - i];
+                rightCount[bins - 2 - i] = rightSum;
+                rightBox.expand(binBounds[axis][bins - 1 - i]);
+                rightArea[bins - 2 - i] = rightBox.surfaceArea();
+            }
+
+            for (int i = 0; i < bins - 1; ++i) {
+                if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+                float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = i;
+                }
+            }
+        }
+
+        // All centroids coincide: nothing to split on
+        if (bestAxis < 0) return false;
+
+        float parentArea = node.bounds.surfaceArea();
+        float splitCost = kTraversalCost + (parentArea > 0.0f ? bestCost / parentArea : 0.0f);
+        if (node.count <= kMaxLeafSize && splitCost >= static_cast<float>(node.count)) {
+            return false;
+        }
+
+        BuildPrim* begin = &prims[node.leftFirst];
+        BuildPrim* end = begin + node.count;
+        BuildPrim* middle = std::partition(begin, end, [&](const BuildPrim& prim) {
+            return binIndex(prim.centroid[bestAxis], lo[bestAxis], scale[bestAxis], bins) <= bestBin;
+        });
+
+        split = node.leftFirst + static_cast<uint32_t>(middle - begin);
+        return true;
+    }
+
+    static int binIndex(float value, float lo, float scale, int bins) {
+        return std::min(bins - 1, static_cast<int>((value - lo) * scale));
+    }
+};
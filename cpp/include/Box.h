@@ -4,127 +4,119 @@
 #include "Ray.h"
 #include "Material.h"
 #include "Sphere.h"  // For HitRecord
+#include "Transform.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
-// Axis-Aligned Bounding Box (AABB)
+// Box, axis-aligned unless given a rotation about its center
 struct Box {
     Vec3 center;
     Vec3 halfSize;  // Half-extents in each dimension
-    Material material;
+    int materialId; // Index into Scene::materials
+
+    // Intersection-ready data; call update() after changing center/halfSize
+    Vec3 minCorner;
+    Vec3 maxCorner;
+
+    Vec3 rotation;           // Euler angles in degrees (see Transform::fromTRS)
+    Transform orientation;   // Local -> world rotation, cached by setRotation()
+    bool oriented;           // False = axis-aligned fast path
 
     Box() 
         : center(Vec3(0.0f, 0.0f, 0.0f))
         , halfSize(Vec3(0.5f, 0.5f, 0.5f))
-        , material() {}
+        , materialId(0)
+        , oriented(false) { update(); }
     
-    Box(const Vec3& c, const Vec3& size, const Material& mat) 
+    Box(const Vec3& c, const Vec3& size, int mat) 
         : center(c)
         , halfSize(size * 0.5f)
-        , material(mat) {}
+        , materialId(mat)
+        , oriented(false) { update(); }
+
+    void update() {
+        minCorner = center - halfSize;
+        maxCorner = center + halfSize;
+    }
+
+    void setRotation(const Vec3& degrees) {
+        rotation = degrees;
+        orientation = Transform::fromTRS(Vec3(), degrees, Vec3(1.0f, 1.0f, 1.0f));
+        oriented = degrees.x != 0.0f || degrees.y != 0.0f || degrees.z != 0.0f;
+    }
 
     // Create a unit cube centered at a position
-    static Box unitCube(const Vec3& center, const Material& mat) {
+    static Box unitCube(const Vec3& center, int mat) {
         return Box(center, Vec3(1.0f, 1.0f, 1.0f), mat);
     }
 
     // Get min and max corners
-    Vec3 getMin() const {
-        return Vec3(center.x - halfSize.x, center.y - halfSize.y, center.z - halfSize.z);
+    const Vec3& getMin() const {
+        return minCorner;
     }
 
-    Vec3 getMax() const {
-        return Vec3(center.x + halfSize.x, center.y + halfSize.y, center.z + halfSize.z);
+    const Vec3& getMax() const {
+        return maxCorner;
     }
 
     HitRecord intersect(const Ray& ray) const {
-        HitRecord record;
-        
-        Vec3 minB = getMin();
-        Vec3 maxB = getMax();
-
-        float tmin = -1e30f;
-        float tmax = 1e30f;
-        Vec3 normalMin, normalMax;
-
-        // X slab
-        if (std::abs(ray.direction.x) > 0.0001f) {
-            float tx1 = (minB.x - ray.origin.x) / ray.direction.x;
-            float tx2 = (maxB.x - ray.origin.x) / ray.direction.x;
-            
-            float tNear = std::min(tx1, tx2);
-            float tFar = std::max(tx1, tx2);
-            
-            Vec3 nNear = Vec3(tx1 < tx2 ? -1.0f : 1.0f, 0.0f, 0.0f);
-            Vec3 nFar = Vec3(tx1 < tx2 ? 1.0f : -1.0f, 0.0f, 0.0f);
-            
-            if (tNear > tmin) { tmin = tNear; normalMin = nNear; }
-            if (tFar < tmax) { tmax = tFar; normalMax = nFar; }
-        } else {
-            if (ray.origin.x < minB.x || ray.origin.x > maxB.x) {
-                return record;
-            }
+        if (!oriented) {
+            return intersectAligned(ray);
         }
 
-        // Y slab
-        if (std::abs(ray.direction.y) > 0.0001f) {
-            float ty1 = (minB.y - ray.origin.y) / ray.direction.y;
-            float ty2 = (maxB.y - ray.origin.y) / ray.direction.y;
-            
-            float tNear = std::min(ty1, ty2);
-            float tFar = std::max(ty1, ty2);
-            
-            Vec3 nNear = Vec3(0.0f, ty1 < ty2 ? -1.0f : 1.0f, 0.0f);
-            Vec3 nFar = Vec3(0.0f, ty1 < ty2 ? 1.0f : -1.0f, 0.0f);
-            
-            if (tNear > tmin) { tmin = tNear; normalMin = nNear; }
-            if (tFar < tmax) { tmax = tFar; normalMax = nFar; }
-        } else {
-            if (ray.origin.y < minB.y || ray.origin.y > maxB.y) {
-                return record;
-            }
-        }
+        // Rotate the ray into box space; the rotation is orthonormal, so its
+        // transpose is the inverse and distances are unchanged
+        Ray local;
+        local.origin = center + orientation.transposedVector(ray.origin - center);
+        local.setDirection(orientation.transposedVector(ray.direction));
 
-        // Z slab
-        if (std::abs(ray.direction.z) > 0.0001f) {
-            float tz1 = (minB.z - ray.origin.z) / ray.direction.z;
-            float tz2 = (maxB.z - ray.origin.z) / ray.direction.z;
-            
-            float tNear = std::min(tz1, tz2);
-            float tFar = std::max(tz1, tz2);
-            
-            Vec3 nNear = Vec3(0.0f, 0.0f, tz1 < tz2 ? -1.0f : 1.0f);
-            Vec3 nFar = Vec3(0.0f, 0.0f, tz1 < tz2 ? 1.0f : -1.0f);
-            
-            if (tNear > tmin) { tmin = tNear; normalMin = nNear; }
-            if (tFar < tmax) { tmax = tFar; normalMax = nFar; }
-        } else {
-            if (ray.origin.z < minB.z || ray.origin.z > maxB.z) {
-                return record;
-            }
+        HitRecord record = intersectAligned(local);
+        if (record.hit) {
+            record.point = ray.at(record.t);
+            record.normal = orientation.vector(record.normal);
         }
+        return record;
+    }
 
-        // Check if we have a valid intersection
-        if (tmin > tmax || tmax < 0.001f) {
-            return record;
-        }
+private:
+    HitRecord intersectAligned(const Ray& ray) const {
+        HitRecord record;
 
-        // Use the appropriate t value and normal
-        float t;
-        Vec3 normal;
-        
-        if (tmin > 0.001f) {
-            t = tmin;
-            normal = normalMin;
-        } else {
-            t = tmax;
-            normal = normalMax;
+        // The sign-picked planes of AABB::slabs, but divided rather than
+        // multiplied by the cached inverse, whose rounding flips grazing hits
+        // on box edges. The axis that sets each bound is kept: its plane is
+        // the face the ray enters (or leaves). Ties keep the lower axis, and
+        // NaN distances fail both compares.
+        const Vec3* bounds[2] = {&minCorner, &maxCorner};
+        float tNear = -std::numeric_limits<float>::infinity();
+        float tFar = std::numeric_limits<float>::infinity();
+        int nearAxis = 0;
+        int farAxis = 0;
+        for (int axis = 0; axis < 3; ++axis) {
+            int s = ray.sign[axis];
+            float origin = ray.origin[axis];
+            float dir = ray.direction[axis];
+            float tEnter = ((*bounds[s])[axis] - origin) / dir;
+            float tExit = ((*bounds[1 - s])[axis] - origin) / dir;
+            if (tEnter > tNear) { tNear = tEnter; nearAxis = axis; }
+            if (tExit < tFar) { tFar = tExit; farAxis = axis; }
+        }
+        if (tNear > tFar || tFar < 0.001f) {
+            return record;
         }
 
+        // Entry face, or the exit face when the ray starts inside. A ray
+        // entering a face moves against its outward normal.
+        bool entering = tNear > 0.001f;
+        float t = entering ? tNear : tFar;
+        int axis = entering ? nearAxis : farAxis;
+        float outward = (ray.sign[axis] != 0) == entering ? 1.0f : -1.0f;
         record.t = t;
         record.point = ray.at(t);
-        record.normal = normal;
-        record.material = material;
+        record.normal = Vec3(axis == 0 ? outward : 0.0f, axis == 1 ? outward : 0.0f, axis == 2 ? outward : 0.0f);
+
+        record.materialId = materialId;
         record.hit = true;
 
         return record;
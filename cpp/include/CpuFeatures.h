@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstring>
+
+// Instruction set levels with their own kernel variants (see Kernels.h)
+enum class CpuIsa {
+    BASELINE = 0,  // Portable scalar code (any target, including WebAssembly)
+    SSE42 = 1,
+    AVX2 = 2,
+    AVX512 = 3     // AVX-512 F/BW/VL
+};
+
+// Runtime dispatch needs GCC/Clang target attributes on x86
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RT_CPU_DISPATCH 1
+#endif
+
+// Highest level the host CPU (and OS, for the wider registers) supports
+inline CpuIsa detectCpuIsa() {
+#if defined(RT_CPU_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl")) {
+        return CpuIsa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return CpuIsa::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return CpuIsa::SSE42;
+    }
+#endif
+    return CpuIsa::BASELINE;
+}
+
+inline const char* cpuIsaName(CpuIsa isa) {
+    switch (isa) {
+        case CpuIsa::SSE42: return "sse4.2";
+        case CpuIsa::AVX2: return "avx2";
+        case CpuIsa::AVX512: return "avx512";
+        default: return "baseline";
+    }
+}
+
+inline bool parseCpuIsa(const char* name, CpuIsa& isa) {
+    for (int level = 0; level <= static_cast<int>(CpuIsa::AVX512); ++level) {
+        if (std::strcmp(name, cpuIsaName(static_cast<CpuIsa>(level))) == 0) {
+            isa = static_cast<CpuIsa>(level);
+            return true;
+        }
+    }
+    return false;
+}
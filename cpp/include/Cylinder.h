@@ -4,150 +4,154 @@
 #include "Ray.h"
 #include "Material.h"
 #include "Sphere.h"  // For HitRecord
+#include "Transform.h"
 #include <cmath>
 #include <algorithm>
 
-// Cylinder aligned along the Y-axis
+// Cylinder along the Y-axis, or along any axis once rotated about its base center
 struct Cylinder {
     Vec3 center;       // Center of the cylinder (base)
     float radius;      // Radius of the cylinder
     float height;      // Height of the cylinder
-    Material material;
+    int materialId;    // Index into Scene::materials
     bool capped;       // Whether to render end caps
 
+    // Intersection-ready data; call update() after changing center/radius/height
+    float yMax;
+    float radius2;
+    float invRadius;
+
+    Vec3 rotation;           // Euler angles in degrees (see Transform::fromTRS)
+    Transform orientation;   // Local -> world rotation, cached by setRotation()
+    bool oriented;           // False = Y-aligned fast path
+
     Cylinder() 
         : center(Vec3(0.0f, 0.0f, 0.0f))
         , radius(0.5f)
         , height(1.0f)
-        , material()
-        , capped(true) {}
+        , materialId(0)
+        , capped(true)
+        , oriented(false) { update(); }
     
-    Cylinder(const Vec3& c, float r, float h, const Material& mat, bool caps = true) 
+    Cylinder(const Vec3& c, float r, float h, int mat, bool caps = true) 
         : center(c)
         , radius(r)
         , height(h)
-        , material(mat)
-        , capped(caps) {}
+        , materialId(mat)
+        , capped(caps)
+        , oriented(false) { update(); }
+
+    void update() {
+        yMax = center.y + height;
+        radius2 = radius * radius;
+        invRadius = 1.0f / radius;
+    }
+
+    void setRotation(const Vec3& degrees) {
+        rotation = degrees;
+        orientation = Transform::fromTRS(Vec3(), degrees, Vec3(1.0f, 1.0f, 1.0f));
+        oriented = degrees.x != 0.0f || degrees.y != 0.0f || degrees.z != 0.0f;
+    }
+
+    // Point the cylinder's axis (base -> top) along a direction
+    void setAxis(const Vec3& axis) {
+        Vec3 d = axis.normalize();
+        const float toDegrees = 180.0f / 3.14159265358979f;
+        float pitch = std::acos(std::fmax(-1.0f, std::fmin(1.0f, d.y))) * toDegrees;
+        float yaw = std::atan2(d.x, d.z) * toDegrees;
+        setRotation(Vec3(pitch, yaw, 0.0f));
+    }
 
     HitRecord intersect(const Ray& ray) const {
+        if (!oriented) {
+            return intersectAligned(ray);
+        }
+
+        // Rotate the ray into cylinder space; the rotation is orthonormal, so
+        // its transpose is the inverse and distances are unchanged
+        Ray local;
+        local.origin = center + orientation.transposedVector(ray.origin - center);
+        local.setDirection(orientation.transposedVector(ray.direction));
+
+        HitRecord record = intersectAligned(local);
+        if (record.hit) {
+            record.point = ray.at(record.t);
+            record.normal = orientation.vector(record.normal);
+        }
+        return record;
+    }
+
+private:
+    // Ray direction is unit length, so the 2D quadratic uses the half-b form
+    // and the caps use the ray's cached reciprocal direction
+    HitRecord intersectAligned(const Ray& ray) const {
         HitRecord record;
-        
-        float yMin = center.y;
-        float yMax = center.y + height;
 
-        // Transform ray to cylinder's local space (cylinder is at origin)
+        float yMin = center.y;
         Vec3 ro = ray.origin - center;
-        Vec3 rd = ray.direction;
+        const Vec3& rd = ray.direction;
 
-        // Solve quadratic for infinite cylinder along Y axis
-        // x² + z² = r²
-        float a = rd.x * rd.x + rd.z * rd.z;
-        float b = 2.0f * (ro.x * rd.x + ro.z * rd.z);
-        float c = ro.x * ro.x + ro.z * ro.z - radius * radius;
+        float tFinal = 1e30f;
+        Vec3 finalNormal;
 
-        float tCylinder = 1e30f;
-        Vec3 cylinderNormal;
-        bool hitCylinder = false;
+        // Cylinder body: x² + z² = r²
+        float a = rd.x * rd.x + rd.z * rd.z;
+        if (a > 1e-8f) {
+            float b = ro.x * rd.x + ro.z * rd.z;
+            float c = ro.x * ro.x + ro.z * ro.z - radius2;
+            float discriminant = b * b - a * c;
 
-        // Check cylinder body
-        if (std::abs(a) > 0.0001f) {
-            float discriminant = b * b - 4.0f * a * c;
-            
             if (discriminant >= 0.0f) {
                 float sqrtD = std::sqrt(discriminant);
-                float t1 = (-b - sqrtD) / (2.0f * a);
-                float t2 = (-b + sqrtD) / (2.0f * a);
-
-                // Check t1
-                if (t1 > 0.001f) {
-                    Vec3 p = ray.at(t1);
-                    if (p.y >= yMin && p.y <= yMax) {
-                        tCylinder = t1;
-                        Vec3 hitPoint = ray.at(t1);
-                        cylinderNormal = Vec3(hitPoint.x - center.x, 0.0f, hitPoint.z - center.z).normalize();
-                        hitCylinder = true;
-                    }
-                }
-                
-                // Check t2 if t1 didn't work
-                if (!hitCylinder && t2 > 0.001f) {
-                    Vec3 p = ray.at(t2);
-                    if (p.y >= yMin && p.y <= yMax) {
-                        tCylinder = t2;
-                        Vec3 hitPoint = ray.at(t2);
-                        cylinderNormal = Vec3(hitPoint.x - center.x, 0.0f, hitPoint.z - center.z).normalize();
-                        hitCylinder = true;
-                    }
+                float invA = 1.0f / a;
+                float t1 = (-b - sqrtD) * invA;
+                float t2 = (-b + sqrtD) * invA;
+
+                float y1 = ray.origin.y + t1 * rd.y;
+                float y2 = ray.origin.y + t2 * rd.y;
+                float t = 1e30f;
+                if (t1 > 0.001f && y1 >= yMin && y1 <= yMax) {
+                    t = t1;
+                } else if (t2 > 0.001f && y2 >= yMin && y2 <= yMax) {
+                    t = t2;
                 }
-            }
-        }
 
-        // Check end caps if enabled
-        float tCap = 1e30f;
-        Vec3 capNormal;
-        bool hitCap = false;
-
-        if (capped && std::abs(rd.y) > 0.0001f) {
-            // Bottom cap (y = yMin)
-            float tBottom = (yMin - ray.origin.y) / rd.y;
-            if (tBottom > 0.001f) {
-                Vec3 p = ray.at(tBottom);
-                float dist2 = (p.x - center.x) * (p.x - center.x) + 
-                              (p.z - center.z) * (p.z - center.z);
-                if (dist2 <= radius * radius) {
-                    if (tBottom < tCap) {
-                        tCap = tBottom;
-                        capNormal = Vec3(0.0f, -1.0f, 0.0f);
-                        hitCap = true;
-                    }
+                if (t < tFinal) {
+                    tFinal = t;
+                    finalNormal = Vec3(ro.x + t * rd.x, 0.0f, ro.z + t * rd.z) * invRadius;
                 }
             }
+        }
 
-            // Top cap (y = yMax)
-            float tTop = (yMax - ray.origin.y) / rd.y;
-            if (tTop > 0.001f) {
-                Vec3 p = ray.at(tTop);
-                float dist2 = (p.x - center.x) * (p.x - center.x) + 
-                              (p.z - center.z) * (p.z - center.z);
-                if (dist2 <= radius * radius) {
-                    if (tTop < tCap) {
-                        tCap = tTop;
-                        capNormal = Vec3(0.0f, 1.0f, 0.0f);
-                        hitCap = true;
-                    }
-                }
-            }
+        // End caps; a ray parallel to them gets infinite t and fails the tests
+        if (capped) {
+            float tBottom = (yMin - ray.origin.y) * ray.invDirection.y;
+            float tTop = (yMax - ray.origin.y) * ray.invDirection.y;
+            capHit(ro, rd, tBottom, -1.0f, tFinal, finalNormal);
+            capHit(ro, rd, tTop, 1.0f, tFinal, finalNormal);
         }
 
-        // Find the closest valid hit
-        float tFinal;
-        Vec3 finalNormal;
-        
-        if (hitCylinder && hitCap) {
-            if (tCylinder < tCap) {
-                tFinal = tCylinder;
-                finalNormal = cylinderNormal;
-            } else {
-                tFinal = tCap;
-                finalNormal = capNormal;
-            }
-        } else if (hitCylinder) {
-            tFinal = tCylinder;
-            finalNormal = cylinderNormal;
-        } else if (hitCap) {
-            tFinal = tCap;
-            finalNormal = capNormal;
-        } else {
+        if (tFinal >= 1e30f) {
             return record;  // No hit
         }
 
         record.t = tFinal;
         record.point = ray.at(tFinal);
         record.normal = finalNormal;
-        record.material = material;
+        record.materialId = materialId;
         record.hit = true;
 
         return record;
     }
-};
 
+    void capHit(const Vec3& ro, const Vec3& rd, float t, float normalY, float& tFinal, Vec3& normal) const {
+        if (t > 0.001f && t < tFinal) {
+            float x = ro.x + t * rd.x;
+            float z = ro.z + t * rd.z;
+            if (x * x + z * z <= radius2) {
+                tFinal = t;
+                normal = Vec3(0.0f, normalY, 0.0f);
+            }
+        }
+    }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "GBuffer.h"
+#include <utility>
+#include <cmath>
+#include <algorithm>
+
+// Edge-avoiding à-trous wavelet filter (Dammertz et al. 2010)
+// Smooths low-sample soft shadow noise while the normal/depth/albedo
+// feature buffers keep geometric and material edges sharp
+class Denoiser {
+public:
+    int iterations;      // Number of à-trous passes (step size doubles each pass)
+    float sigmaColor;    // Color edge-stopping (relaxed each pass)
+    float sigmaNormal;   // Normal edge-stopping
+    float sigmaDepth;    // Relative depth edge-stopping
+    float sigmaAlbedo;   // Albedo edge-stopping
+
+    Denoiser()
+        : iterations(4)
+        , sigmaColor(0.6f)
+        , sigmaNormal(0.3f)
+        , sigmaDepth(0.05f)
+        , sigmaAlbedo(0.1f) {}
+
+    void setIterations(int count) {
+        iterations = std::max(1, std::min(6, count));
+    }
+
+    // Arena bytes apply() takes for a w x h frame
+    static size_t frameBytes(int w, int h) {
+        return 2 * RenderArena::bytesFor<float>(static_cast<size_t>(w) * h * 3);
+    }
+
+    // Filter an RGB float image in place (3 floats per pixel)
+    // Working buffers come from the frame's arena
+    void apply(ArenaSpan<float> color, const GBuffer& features, RenderArena& arena) {
+        int width = features.width;
+        int height = features.height;
+        size_t count = static_cast<size_t>(width) * height;
+
+        // Demodulate albedo so surface color and grid lines are not blurred,
+        // only the illumination term is filtered
+        ArenaSpan<float> illumination = arena.allocate<float>(count * 3);
+        for (size_t i = 0; i < count * 3; ++i) {
+            illumination[i] = color[i] / (features.albedo[i] + kAlbedoEpsilon);
+        }
+
+        ArenaSpan<float> scratch = arena.allocate<float>(count * 3);
+        float invSigmaNormal2 = 1.0f / (sigmaNormal * sigmaNormal);
+        float invSigmaAlbedo2 = 1.0f / (sigmaAlbedo * sigmaAlbedo);
+
+        for (int pass = 0; pass < iterations; ++pass) {
+            int step = 1 << pass;
+            float sigmaC = sigmaColor / static_cast<float>(1 << pass);
+            float invSigmaColor2 = 1.0f / (sigmaC * sigmaC);
+
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    int p = y * width + x;
+                    const float* cp = &illumination[p * 3];
+                    float* out = &scratch[p * 3];
+
+                    float zp = features.depth[p];
+                    if (zp <= 0.0f) {
+                        // Background has no shading noise
+                        out[0] = cp[0]; out[1] = cp[1]; out[2] = cp[2];
+                        continue;
+                    }
+
+                    const float* np = &features.normal[p * 3];
+                    const float* ap = &features.albedo[p * 3];
+                    float invDepthScale = 1.0f / (sigmaDepth * zp + 1e-4f);
+
+                    float sum[3] = {0.0f, 0.0f, 0.0f};
+                    float weightSum = 0.0f;
+
+                    for (int ky = -2; ky <= 2; ++ky) {
+                        int qy = y + ky * step;
+                        if (qy < 0 || qy >= height) continue;
+
+                        for (int kx = -2; kx <= 2; ++kx) {
+                            int qx = x + kx * step;
+                            if (qx < 0 || qx >= width) continue;
+
+                            int q = qy * width + qx;
+                            float zq = features.depth[q];
+                            if (zq <= 0.0f) continue;
+
+                            const float* cq = &illumination[q * 3];
+                            const float* nq = &features.normal[q * 3];
+                            const float* aq = &features.albedo[q * 3];
+
+                            float dc = distance2(cp, cq);
+                            float dn = distance2(np, nq);
+                            float da = distance2(ap, aq);
+                            float dz = std::abs(zp - zq) * invDepthScale;
+
+                            float w = kKernel[kx + 2] * kKernel[ky + 2] *
+                                      std::exp(-dc * invSigmaColor2
+                                               - dn * invSigmaNormal2
+                                               - da * invSigmaAlbedo2
+                                               - dz);
+
+                            sum[0] += cq[0] * w;
+                            sum[1] += cq[1] * w;
+                            sum[2] += cq[2] * w;
+                            weightSum += w;
+                        }
+                    }
+
+                    // Center tap always contributes, so weightSum > 0
+                    float invW = 1.0f / weightSum;
+                    out[0] = sum[0] * invW;
+                    out[1] = sum[1] * invW;
+                    out[2] = sum[2] * invW;
+                }
+            }
+
+            std::swap(illumination, scratch);
+        }
+
+        // Remodulate
+        for (size_t i = 0; i < count * 3; ++i) {
+            color[i] = illumination[i] * (features.albedo[i] + kAlbedoEpsilon);
+        }
+    }
+
+private:
+    static constexpr float kAlbedoEpsilon = 0.01f;
+    static constexpr float kKernel[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+
+    static float distance2(const float* a, const float* b) {
+        float dx = a[0] - b[0];
+        float dy = a[1] - b[1];
+        float dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+};
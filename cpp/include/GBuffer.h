@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Sphere.h"  // For HitRecord
+#include "RenderArena.h"
+#include <algorithm>
+#include <cstdint>
+
+// Per-pixel auxiliary (AOV) buffers written during the primary pass
+// Used as edge-stopping guides by the denoiser and exported for picking/compositing
+struct GBuffer {
+    int width;
+    int height;
+    ArenaSpan<float> depth;    // Primary hit distance (0 = background)
+    ArenaSpan<float> normal;   // World-space normal, 3 floats per pixel
+    ArenaSpan<float> albedo;   // Surface color, 3 floats per pixel
+    ArenaSpan<int32_t> objectId;    // packObjectId(type, index), -1 = background
+    ArenaSpan<int32_t> materialId;  // Scene material ID, -1 = background
+
+    GBuffer() : width(0), height(0) {}
+
+    // Object IDs carry the primitive type in the top byte and the index below it
+    static int32_t packObjectId(ObjectType type, int index) {
+        return (static_cast<int32_t>(type) << 24) | (index & 0xFFFFFF);
+    }
+
+    static ObjectType objectIdType(int32_t id) {
+        return id < 0 ? ObjectType::NONE : static_cast<ObjectType>(id >> 24);
+    }
+
+    static int objectIdIndex(int32_t id) {
+        return id < 0 ? -1 : (id & 0xFFFFFF);
+    }
+
+    // Arena bytes bind() takes for a w x h frame
+    static size_t frameBytes(int w, int h) {
+        size_t count = static_cast<size_t>(w) * h;
+        return RenderArena::bytesFor<float>(count) + 2 * RenderArena::bytesFor<float>(count * 3) +
+               2 * RenderArena::bytesFor<int32_t>(count);
+    }
+
+    // Point the channels at arena memory for a w x h frame (contents undefined)
+    void bind(RenderArena& arena, int w, int h) {
+        width = w;
+        height = h;
+        size_t count = static_cast<size_t>(w) * h;
+        depth = arena.allocate<float>(count);
+        normal = arena.allocate<float>(count * 3);
+        albedo = arena.allocate<float>(count * 3);
+        objectId = arena.allocate<int32_t>(count);
+        materialId = arena.allocate<int32_t>(count);
+    }
+
+    void clear() {
+        std::fill(depth.begin(), depth.end(), 0.0f);
+        std::fill(normal.begin(), normal.end(), 0.0f);
+        std::fill(albedo.begin(), albedo.end(), 0.0f);
+        std::fill(objectId.begin(), objectId.end(), -1);
+        std::fill(materialId.begin(), materialId.end(), -1);
+    }
+
+    // Add a weighted primary hit to a pixel (weights sum to 1 across AA samples)
+    void accumulate(int pixel, const HitRecord& hit, float weight) {
+        depth[pixel] += hit.t * weight;
+
+        float* n = &normal[pixel * 3];
+        n[0] += hit.normal.x * weight;
+        n[1] += hit.normal.y * weight;
+        n[2] += hit.normal.z * weight;
+
+        float* a = &albedo[pixel * 3];
+        a[0] += hit.material.color.x * weight;
+        a[1] += hit.material.color.y * weight;
+        a[2] += hit.material.color.z * weight;
+
+        // IDs cannot be averaged; the first AA sample that hits wins
+        if (objectId[pixel] < 0) {
+            objectId[pixel] = packObjectId(hit.objectType, hit.objectIndex);
+            materialId[pixel] = hit.materialId;
+        }
+    }
+};
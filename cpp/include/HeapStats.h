@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// ============================================================================
+// Global heap allocation counter
+// ============================================================================
+//
+// Counts every operator new so callers can check that a steady-state frame
+// allocates nothing (Renderer::frameAllocations). The counting operators are
+// defined by the one translation unit that defines RT_HEAP_STATS_IMPLEMENTATION
+// before including this header (core.cpp, cli.cpp); without it the counter
+// stays at 0.
+
+namespace heapstats {
+
+inline std::atomic<uint64_t> allocationCount{0};
+inline std::atomic<uint64_t> allocatedBytes{0};
+
+inline uint64_t allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+inline uint64_t bytes() {
+    return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+inline void* allocate(std::size_t size, std::size_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size);
+    } else {
+        // aligned_alloc wants a size that is a multiple of the alignment
+        p = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+    }
+    if (!p) {
+#if defined(__cpp_exceptions)
+        throw std::bad_alloc();
+#else
+        std::abort();
+#endif
+    }
+    return p;
+}
+
+}  // namespace heapstats
+
+#if defined(RT_HEAP_STATS_IMPLEMENTATION)
+
+// The array and nothrow forms route through these by default
+void* operator new(std::size_t size) {
+    return heapstats::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return heapstats::allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+#endif
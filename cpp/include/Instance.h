@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Mesh.h"
+#include "Transform.h"
+#include "AABB.h"
+
+// A placement of a shared Mesh: its own transform and optional material
+// Many instances can reference one mesh, so memory scales with unique geometry
+struct Instance {
+    int meshIndex;            // Index into Scene::meshes
+    int materialId;           // Material override, -1 = use the mesh's material
+    Transform objectToWorld;
+    Transform worldToObject;  // Cached inverse, so rays never invert a matrix
+    AABB bounds;              // World-space bounds, refreshed by Scene
+
+    Instance() : meshIndex(0), materialId(-1) {}
+
+    Instance(int mesh, const Transform& xf, int mat = -1)
+        : meshIndex(mesh), materialId(mat) {
+        setTransform(xf);
+    }
+
+    void setTransform(const Transform& xf) {
+        objectToWorld = xf;
+        worldToObject = xf.inverse();
+    }
+
+    // World bounds of the mesh's local bounds after transformation
+    void updateBounds(const Mesh& mesh) {
+        bounds = AABB();
+        if (mesh.bvh.empty()) return;
+        const AABB& local = mesh.bvh.bounds();
+        for (int corner = 0; corner < 8; ++corner) {
+            Vec3 p((corner & 1) ? local.max.x : local.min.x,
+                   (corner & 2) ? local.max.y : local.min.y,
+                   (corner & 4) ? local.max.z : local.min.z);
+            bounds.expand(objectToWorld.point(p));
+        }
+    }
+
+    // Closest hit closer than tMax (world units)
+    HitRecord intersect(const Mesh& mesh, const Ray& ray, float tMax) const {
+        // Local rays are renormalized, so distances scale by the direction's stretch
+        Vec3 localDir = worldToObject.vector(ray.direction);
+        float stretch = localDir.length();
+        Ray localRay(worldToObject.point(ray.origin), localDir);
+
+        HitRecord record = mesh.intersect(localRay, tMax * stretch);
+        if (!record.hit) {
+            return record;
+        }
+
+        record.t /= stretch;
+        record.point = ray.at(record.t);
+        record.normal = worldToObject.transposedVector(record.normal).normalize();
+        if (materialId >= 0) {
+            record.materialId = materialId;
+        }
+        return record;
+    }
+
+    bool occluded(const Mesh& mesh, const Ray& ray, float maxT, uint32_t* blocker = nullptr) const {
+        Vec3 localDir = worldToObject.vector(ray.direction);
+        float stretch = localDir.length();
+        Ray localRay(worldToObject.point(ray.origin), localDir);
+        return mesh.occluded(localRay, maxT * stretch, blocker);
+    }
+
+    bool occludedByTriangle(const Mesh& mesh, const Ray& ray, float maxT, uint32_t triangle) const {
+        Vec3 localDir = worldToObject.vector(ray.direction);
+        float stretch = localDir.length();
+        Ray localRay(worldToObject.point(ray.origin), localDir);
+        return mesh.occludedByTriangle(localRay, maxT * stretch, triangle);
+    }
+};
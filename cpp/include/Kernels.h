@@ -0,0 +1,423 @@
+#pragma once
+
+#include "CpuFeatures.h"
+#include "Sphere.h"
+#include "Ray.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+
+#if defined(RT_CPU_DISPATCH)
+#include <immintrin.h>
+#define RT_TARGET(isa) __attribute__((target(isa)))
+// GCC fuses separate mul/add intrinsics once FMA is enabled (AVX-512 implies it)
+#if defined(__clang__)
+#define RT_NO_CONTRACT
+#else
+#define RT_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+#endif
+
+// ============================================================================
+// Runtime-dispatched kernels
+// ============================================================================
+//
+// Hot loops that work on flat arrays get one variant per instruction set.
+// Each variant is compiled with its own target attribute, so a single native
+// binary carries SSE4.2, AVX2 and AVX-512 code and picks the widest one the
+// host supports on first use (CPUID). Other targets only have the baseline.
+
+// Structure-of-arrays copy of the scene spheres for the wide intersection
+// kernels, padded to a multiple of kLanes with spheres no ray can hit
+struct SphereBatch {
+    static constexpr size_t kLanes = 16;
+
+    std::vector<float> centerX, centerY, centerZ, radius2;
+    size_t count;             // Real spheres (the rest is padding)
+    unsigned int revision;    // Scene::geometryRevision it was built from
+
+    SphereBatch() : count(0), revision(~0u) {}
+
+    void build(const std::vector<Sphere>& spheres, unsigned int geometryRevision) {
+        count = spheres.size();
+        revision = geometryRevision;
+        size_t padded = (count + kLanes - 1) / kLanes * kLanes;
+        centerX.assign(padded, 0.0f);
+        centerY.assign(padded, 0.0f);
+        centerZ.assign(padded, 0.0f);
+        // c = |oc|^2 - r^2 = +inf makes the discriminant -inf: always a miss
+        radius2.assign(padded, -std::numeric_limits<float>::infinity());
+        for (size_t i = 0; i < count; ++i) {
+            centerX[i] = spheres[i].center.x;
+            centerY[i] = spheres[i].center.y;
+            centerZ[i] = spheres[i].center.z;
+            radius2[i] = spheres[i].radius2;
+        }
+    }
+
+    size_t paddedCount() const {
+        return radius2.size();
+    }
+};
+
+struct KernelTable {
+    CpuIsa isa;
+
+    // Sphere tests over a SphereBatch, with the same math as Sphere::intersect.
+    // Null for the baseline, where the per-sphere loop is as fast.
+
+    // Closest sphere hit nearer than tMax: its index and distance, or -1
+    int (*nearestSphere)(const SphereBatch& batch, const Ray& ray, float tMax, float& tHit);
+
+    // Lowest-index sphere hit nearer than tMax (shadow rays), or -1
+    int (*firstSphereHit)(const SphereBatch& batch, const Ray& ray, float tMax);
+
+    // Clamp to [0, 1] and scale to bytes, truncating like Vec3::clamp() * 255
+    // (NaN becomes 255); count floats in, count bytes out
+    void (*quantize)(const float* in, uint8_t* out, size_t count);
+};
+
+namespace kernels {
+
+static constexpr float kNoHit = 1e30f;
+static constexpr float kEpsilon = 0.001f;
+
+// ----------------------------------------------------------------------------
+// Baseline (portable scalar)
+// ----------------------------------------------------------------------------
+
+inline void quantizeScalar(const float* in, uint8_t* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        float c = in[i];
+        c = c < 1.0f ? (c > 0.0f ? c : 0.0f) : 1.0f;
+        out[i] = static_cast<uint8_t>(c * 255.0f);
+    }
+}
+
+// Pick the lowest index among the lanes holding the smallest distance
+inline int reduceNearest(const float* t, const int32_t* index, int lanes, float& tHit) {
+    int best = -1;
+    for (int l = 0; l < lanes; ++l) {
+        if (index[l] >= 0 && (best < 0 || t[l] < tHit || (t[l] == tHit && index[l] < best))) {
+            tHit = t[l];
+            best = index[l];
+        }
+    }
+    return best;
+}
+
+#if defined(RT_CPU_DISPATCH)
+
+// Each ISA section has a sphere distance helper (inlined into the kernels of
+// the same target) plus the nearest/first-hit reductions built on it.
+// Missed lanes and the batch padding come out as kNoHit. The distance math
+// keeps Sphere::intersect's operation order and avoids FMA (the discriminant
+// cancels badly), so every level picks exactly the spheres the scalar code does.
+
+// ----------------------------------------------------------------------------
+// SSE4.2 (4 lanes)
+// ----------------------------------------------------------------------------
+
+struct RaySse42 {
+    __m128 ox, oy, oz, dx, dy, dz;
+};
+
+RT_TARGET("sse4.2")
+inline RaySse42 broadcastSse42(const Ray& ray) {
+    return {_mm_set1_ps(ray.origin.x), _mm_set1_ps(ray.origin.y), _mm_set1_ps(ray.origin.z),
+            _mm_set1_ps(ray.direction.x), _mm_set1_ps(ray.direction.y), _mm_set1_ps(ray.direction.z)};
+}
+
+RT_TARGET("sse4.2")
+inline __m128 sphereDistanceSse42(const SphereBatch& batch, size_t i, const RaySse42& r) {
+    const __m128 eps = _mm_set1_ps(kEpsilon), zero = _mm_setzero_ps();
+    __m128 ocx = _mm_sub_ps(r.ox, _mm_loadu_ps(&batch.centerX[i]));
+    __m128 ocy = _mm_sub_ps(r.oy, _mm_loadu_ps(&batch.centerY[i]));
+    __m128 ocz = _mm_sub_ps(r.oz, _mm_loadu_ps(&batch.centerZ[i]));
+    __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, r.dx), _mm_mul_ps(ocy, r.dy)), _mm_mul_ps(ocz, r.dz));
+    __m128 oc2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz));
+    __m128 disc = _mm_sub_ps(_mm_mul_ps(b, b), _mm_sub_ps(oc2, _mm_loadu_ps(&batch.radius2[i])));
+    __m128 s = _mm_sqrt_ps(_mm_max_ps(disc, zero));
+    __m128 nb = _mm_sub_ps(zero, b);
+    __m128 near = _mm_sub_ps(nb, s);
+    __m128 hit = _mm_blendv_ps(_mm_add_ps(nb, s), near, _mm_cmpgt_ps(near, eps));
+    __m128 valid = _mm_and_ps(_mm_cmpge_ps(disc, zero), _mm_cmpgt_ps(hit, eps));
+    return _mm_blendv_ps(_mm_set1_ps(kNoHit), hit, valid);
+}
+
+RT_TARGET("sse4.2")
+inline int nearestSphereSse42(const SphereBatch& batch, const Ray& ray, float tMax, float& tHit) {
+    RaySse42 r = broadcastSse42(ray);
+    __m128 best = _mm_set1_ps(tMax);
+    __m128i bestIndex = _mm_set1_epi32(-1);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    for (size_t i = 0; i < batch.paddedCount(); i += 4) {
+        __m128 t = sphereDistanceSse42(batch, i, r);
+        __m128 closer = _mm_cmplt_ps(t, best);
+        best = _mm_blendv_ps(best, t, closer);
+        bestIndex = _mm_blendv_epi8(bestIndex, index, _mm_castps_si128(closer));
+        index = _mm_add_epi32(index, _mm_set1_epi32(4));
+    }
+    alignas(16) float t[4];
+    alignas(16) int32_t id[4];
+    _mm_store_ps(t, best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(id), bestIndex);
+    return reduceNearest(t, id, 4, tHit);
+}
+
+RT_TARGET("sse4.2")
+inline int firstSphereHitSse42(const SphereBatch& batch, const Ray& ray, float tMax) {
+    RaySse42 r = broadcastSse42(ray);
+    __m128 limit = _mm_set1_ps(tMax);
+    for (size_t i = 0; i < batch.paddedCount(); i += 4) {
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(sphereDistanceSse42(batch, i, r), limit));
+        if (mask) return static_cast<int>(i) + __builtin_ctz(mask);
+    }
+    return -1;
+}
+
+RT_TARGET("sse4.2")
+inline void quantizeSse42(const float* in, uint8_t* out, size_t count) {
+    const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), scale = _mm_set1_ps(255.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i c[4];
+        for (int k = 0; k < 4; ++k) {
+            // min(x, 1) returns 1 for NaN, then max keeps it
+            __m128 v = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(in + i + 4 * k), one), zero);
+            c[k] = _mm_cvttps_epi32(_mm_mul_ps(v, scale));
+        }
+        __m128i lo = _mm_packs_epi32(c[0], c[1]);
+        __m128i hi = _mm_packs_epi32(c[2], c[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+    quantizeScalar(in + i, out + i, count - i);
+}
+
+// ----------------------------------------------------------------------------
+// AVX2 (8 lanes)
+// ----------------------------------------------------------------------------
+
+struct RayAvx2 {
+    __m256 ox, oy, oz, dx, dy, dz;
+};
+
+RT_TARGET("avx2")
+inline RayAvx2 broadcastAvx2(const Ray& ray) {
+    return {_mm256_set1_ps(ray.origin.x), _mm256_set1_ps(ray.origin.y), _mm256_set1_ps(ray.origin.z),
+            _mm256_set1_ps(ray.direction.x), _mm256_set1_ps(ray.direction.y), _mm256_set1_ps(ray.direction.z)};
+}
+
+RT_TARGET("avx2")
+inline __m256 sphereDistanceAvx2(const SphereBatch& batch, size_t i, const RayAvx2& r) {
+    const __m256 eps = _mm256_set1_ps(kEpsilon), zero = _mm256_setzero_ps();
+    __m256 ocx = _mm256_sub_ps(r.ox, _mm256_loadu_ps(&batch.centerX[i]));
+    __m256 ocy = _mm256_sub_ps(r.oy, _mm256_loadu_ps(&batch.centerY[i]));
+    __m256 ocz = _mm256_sub_ps(r.oz, _mm256_loadu_ps(&batch.centerZ[i]));
+    __m256 b = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, r.dx), _mm256_mul_ps(ocy, r.dy)),
+                             _mm256_mul_ps(ocz, r.dz));
+    __m256 oc2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ocx, ocx), _mm256_mul_ps(ocy, ocy)),
+                               _mm256_mul_ps(ocz, ocz));
+    __m256 disc = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_sub_ps(oc2, _mm256_loadu_ps(&batch.radius2[i])));
+    __m256 s = _mm256_sqrt_ps(_mm256_max_ps(disc, zero));
+    __m256 nb = _mm256_sub_ps(zero, b);
+    __m256 near = _mm256_sub_ps(nb, s);
+    __m256 hit = _mm256_blendv_ps(_mm256_add_ps(nb, s), near, _mm256_cmp_ps(near, eps, _CMP_GT_OQ));
+    __m256 valid = _mm256_and_ps(_mm256_cmp_ps(disc, zero, _CMP_GE_OQ), _mm256_cmp_ps(hit, eps, _CMP_GT_OQ));
+    return _mm256_blendv_ps(_mm256_set1_ps(kNoHit), hit, valid);
+}
+
+RT_TARGET("avx2")
+inline int nearestSphereAvx2(const SphereBatch& batch, const Ray& ray, float tMax, float& tHit) {
+    RayAvx2 r = broadcastAvx2(ray);
+    __m256 best = _mm256_set1_ps(tMax);
+    __m256i bestIndex = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (size_t i = 0; i < batch.paddedCount(); i += 8) {
+        __m256 t = sphereDistanceAvx2(batch, i, r);
+        __m256 closer = _mm256_cmp_ps(t, best, _CMP_LT_OQ);
+        best = _mm256_blendv_ps(best, t, closer);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, _mm256_castps_si256(closer));
+        index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+    }
+    alignas(32) float t[8];
+    alignas(32) int32_t id[8];
+    _mm256_store_ps(t, best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(id), bestIndex);
+    return reduceNearest(t, id, 8, tHit);
+}
+
+RT_TARGET("avx2")
+inline int firstSphereHitAvx2(const SphereBatch& batch, const Ray& ray, float tMax) {
+    RayAvx2 r = broadcastAvx2(ray);
+    __m256 limit = _mm256_set1_ps(tMax);
+    for (size_t i = 0; i < batch.paddedCount(); i += 8) {
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(sphereDistanceAvx2(batch, i, r), limit, _CMP_LT_OQ));
+        if (mask) return static_cast<int>(i) + __builtin_ctz(mask);
+    }
+    return -1;
+}
+
+RT_TARGET("avx2")
+inline void quantizeAvx2(const float* in, uint8_t* out, size_t count) {
+    const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps(), scale = _mm256_set1_ps(255.0f);
+    // Packing works per 128-bit half; this gathers the dwords back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i c[4];
+        for (int k = 0; k < 4; ++k) {
+            __m256 v = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i + 8 * k), one), zero);
+            c[k] = _mm256_cvttps_epi32(_mm256_mul_ps(v, scale));
+        }
+        __m256i lo = _mm256_packs_epi32(c[0], c[1]);
+        __m256i hi = _mm256_packs_epi32(c[2], c[3]);
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(lo, hi), order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+    }
+    quantizeScalar(in + i, out + i, count - i);
+}
+
+// ----------------------------------------------------------------------------
+// AVX-512 (16 lanes)
+// ----------------------------------------------------------------------------
+
+// Zero-masked forms with a full mask give the same results as the plain
+// intrinsics but don't trip GCC's -Wmaybe-uninitialized in its own headers
+static constexpr __mmask16 kAllLanes = 0xFFFF;
+
+struct RayAvx512 {
+    __m512 ox, oy, oz, dx, dy, dz;
+};
+
+RT_TARGET("avx512f,avx512bw,avx512vl") RT_NO_CONTRACT
+inline RayAvx512 broadcastAvx512(const Ray& ray) {
+    return {_mm512_set1_ps(ray.origin.x), _mm512_set1_ps(ray.origin.y), _mm512_set1_ps(ray.origin.z),
+            _mm512_set1_ps(ray.direction.x), _mm512_set1_ps(ray.direction.y), _mm512_set1_ps(ray.direction.z)};
+}
+
+RT_TARGET("avx512f,avx512bw,avx512vl") RT_NO_CONTRACT
+inline __m512 sphereDistanceAvx512(const SphereBatch& batch, size_t i, const RayAvx512& r) {
+    const __m512 eps = _mm512_set1_ps(kEpsilon), zero = _mm512_setzero_ps();
+    __m512 ocx = _mm512_sub_ps(r.ox, _mm512_loadu_ps(&batch.centerX[i]));
+    __m512 ocy = _mm512_sub_ps(r.oy, _mm512_loadu_ps(&batch.centerY[i]));
+    __m512 ocz = _mm512_sub_ps(r.oz, _mm512_loadu_ps(&batch.centerZ[i]));
+    __m512 b = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(ocx, r.dx), _mm512_mul_ps(ocy, r.dy)),
+                             _mm512_mul_ps(ocz, r.dz));
+    __m512 oc2 = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(ocx, ocx), _mm512_mul_ps(ocy, ocy)),
+                               _mm512_mul_ps(ocz, ocz));
+    __m512 disc = _mm512_sub_ps(_mm512_mul_ps(b, b), _mm512_sub_ps(oc2, _mm512_loadu_ps(&batch.radius2[i])));
+    __mmask16 real = _mm512_cmp_ps_mask(disc, zero, _CMP_GE_OQ);
+    __m512 s = _mm512_maskz_sqrt_ps(real, disc);
+    __m512 nb = _mm512_sub_ps(zero, b);
+    __m512 near = _mm512_sub_ps(nb, s);
+    __m512 hit = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(near, eps, _CMP_GT_OQ), _mm512_add_ps(nb, s), near);
+    __mmask16 valid = real & _mm512_cmp_ps_mask(hit, eps, _CMP_GT_OQ);
+    return _mm512_mask_blend_ps(valid, _mm512_set1_ps(kNoHit), hit);
+}
+
+RT_TARGET("avx512f,avx512bw,avx512vl") RT_NO_CONTRACT
+inline int nearestSphereAvx512(const SphereBatch& batch, const Ray& ray, float tMax, float& tHit) {
+    RayAvx512 r = broadcastAvx512(ray);
+    __m512 best = _mm512_set1_ps(tMax);
+    __m512i bestIndex = _mm512_set1_epi32(-1);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (size_t i = 0; i < batch.paddedCount(); i += 16) {
+        __m512 t = sphereDistanceAvx512(batch, i, r);
+        __mmask16 closer = _mm512_cmp_ps_mask(t, best, _CMP_LT_OQ);
+        best = _mm512_mask_blend_ps(closer, best, t);
+        bestIndex = _mm512_mask_blend_epi32(closer, bestIndex, index);
+        index = _mm512_add_epi32(index, _mm512_set1_epi32(16));
+    }
+    alignas(64) float t[16];
+    alignas(64) int32_t id[16];
+    _mm512_store_ps(t, best);
+    _mm512_store_si512(id, bestIndex);
+    return reduceNearest(t, id, 16, tHit);
+}
+
+RT_TARGET("avx512f,avx512bw,avx512vl") RT_NO_CONTRACT
+inline int firstSphereHitAvx512(const SphereBatch& batch, const Ray& ray, float tMax) {
+    RayAvx512 r = broadcastAvx512(ray);
+    __m512 limit = _mm512_set1_ps(tMax);
+    for (size_t i = 0; i < batch.paddedCount(); i += 16) {
+        __mmask16 mask = _mm512_cmp_ps_mask(sphereDistanceAvx512(batch, i, r), limit, _CMP_LT_OQ);
+        if (mask) return static_cast<int>(i) + __builtin_ctz(mask);
+    }
+    return -1;
+}
+
+RT_TARGET("avx512f,avx512bw,avx512vl") RT_NO_CONTRACT
+inline void quantizeAvx512(const float* in, uint8_t* out, size_t count) {
+    const __m512 one = _mm512_set1_ps(1.0f), zero = _mm512_setzero_ps(), scale = _mm512_set1_ps(255.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_maskz_max_ps(kAllLanes, _mm512_maskz_min_ps(kAllLanes, _mm512_loadu_ps(in + i), one), zero);
+        // Values are already 0-255, so the truncating narrow is exact
+        __m512i c = _mm512_maskz_cvttps_epi32(kAllLanes, _mm512_mul_ps(v, scale));
+        __m128i bytes = _mm512_maskz_cvtepi32_epi8(kAllLanes, c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), bytes);
+    }
+    quantizeScalar(in + i, out + i, count - i);
+}
+
+#endif  // RT_CPU_DISPATCH
+
+inline KernelTable makeTable(CpuIsa isa) {
+    KernelTable table;
+    table.isa = CpuIsa::BASELINE;
+    table.nearestSphere = nullptr;
+    table.firstSphereHit = nullptr;
+    table.quantize = quantizeScalar;
+#if defined(RT_CPU_DISPATCH)
+    switch (isa) {
+        case CpuIsa::AVX512:
+            table.isa = isa;
+            table.nearestSphere = nearestSphereAvx512;
+            table.firstSphereHit = firstSphereHitAvx512;
+            table.quantize = quantizeAvx512;
+            break;
+        case CpuIsa::AVX2:
+            table.isa = isa;
+            table.nearestSphere = nearestSphereAvx2;
+            table.firstSphereHit = firstSphereHitAvx2;
+            table.quantize = quantizeAvx2;
+            break;
+        case CpuIsa::SSE42:
+            table.isa = isa;
+            table.nearestSphere = nearestSphereSse42;
+            table.firstSphereHit = firstSphereHitSse42;
+            table.quantize = quantizeSse42;
+            break;
+        default:
+            break;
+    }
+#else
+    (void)isa;
+#endif
+    return table;
+}
+
+inline KernelTable& activeTable() {
+    static KernelTable table = makeTable(detectCpuIsa());
+    return table;
+}
+
+}  // namespace kernels
+
+// Kernels for the host CPU, selected on first use
+inline const KernelTable& cpuKernels() {
+    return kernels::activeTable();
+}
+
+// Force a lower level (for testing and benchmarks); false if the host
+// can't run it. Not thread-safe: call before rendering starts
+inline bool selectCpuKernels(CpuIsa isa) {
+    if (static_cast<int>(isa) > static_cast<int>(detectCpuIsa())) {
+        return false;
+    }
+    kernels::activeTable() = kernels::makeTable(isa);
+    return true;
+}
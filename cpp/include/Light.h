@@ -1,30 +1,128 @@
 #pragma once
 
 #include "Vec3.h"
+#include <cmath>
+#include <limits>
+
+enum class LightType {
+    POINT,        // Omnidirectional; a disk area light when radius > 0
+    DIRECTIONAL,  // Parallel rays along direction, no position or falloff
+    SPOT          // Point light limited to a cone around direction
+};
 
 struct Light {
+    LightType type;
     Vec3 position;
+    Vec3 direction;      // Unit vector the light shines along (directional, spot)
     Vec3 color;
     float intensity;
-    float radius;  // For area light / soft shadows (0 = point light)
+    float radius;        // For area light / soft shadows (0 = point light)
+    float range;         // Influence radius with smooth falloff (0 = unbounded, no falloff)
+    float spotAngle;     // Spot cone half-angle in degrees
+    float spotSoftness;  // Share of the cone (0-1) that fades out toward its edge
+
+    // Cached by update()
+    float cosOuter;
+    float cosInner;
+
+    // Contributions below this (one 8-bit step) are treated as invisible
+    static constexpr float kCutoff = 1.0f / 256.0f;
 
     Light() 
-        : position(Vec3(2.0f, 2.0f, -1.0f))
+        : type(LightType::POINT)
+        , position(Vec3(2.0f, 2.0f, -1.0f))
+        , direction(Vec3(0.0f, -1.0f, 0.0f))
         , color(Vec3(1.0f, 1.0f, 1.0f))
         , intensity(1.0f)
-        , radius(0.5f) {}
+        , radius(0.5f)
+        , range(0.0f)
+        , spotAngle(30.0f)
+        , spotSoftness(0.2f) {
+        update();
+    }
 
     Light(const Vec3& pos, const Vec3& col, float intens)
-        : position(pos)
+        : type(LightType::POINT)
+        , position(pos)
+        , direction(Vec3(0.0f, -1.0f, 0.0f))
         , color(col)
         , intensity(intens)
-        , radius(0.5f) {}
+        , radius(0.5f)
+        , range(0.0f)
+        , spotAngle(30.0f)
+        , spotSoftness(0.2f) {
+        update();
+    }
 
     Light(const Vec3& pos, const Vec3& col, float intens, float rad)
-        : position(pos)
+        : type(LightType::POINT)
+        , position(pos)
+        , direction(Vec3(0.0f, -1.0f, 0.0f))
         , color(col)
         , intensity(intens)
-        , radius(rad) {}
+        , radius(rad)
+        , range(0.0f)
+        , spotAngle(30.0f)
+        , spotSoftness(0.2f) {
+        update();
+    }
+
+    // Refresh the cached cone cosines; call after changing spotAngle/spotSoftness
+    void update() {
+        const float toRadians = 3.14159265f / 180.0f;
+        cosOuter = std::cos(spotAngle * toRadians);
+        cosInner = std::cos(spotAngle * (1.0f - spotSoftness) * toRadians);
+    }
+
+    // Unit vector from p toward the light
+    Vec3 directionFrom(const Vec3& p) const {
+        if (type == LightType::DIRECTIONAL) return direction * -1.0f;
+        return (position - p).normalize();
+    }
+
+    // Shadow rays toward a directional light never end
+    float distanceFrom(const Vec3& p) const {
+        if (type == LightType::DIRECTIONAL) return std::numeric_limits<float>::infinity();
+        return (position - p).length();
+    }
+
+    // Spot cone weight at p: 1 inside the inner cone, smoothly 0 at the edge
+    // (always 1 for other light types)
+    float coneFactor(const Vec3& p) const {
+        if (type != LightType::SPOT) return 1.0f;
+        Vec3 toPoint = p - position;
+        float distance2 = toPoint.lengthSquared();
+        if (distance2 <= 0.0f) return 1.0f;
+        float cosAngle = direction.dot(toPoint) / std::sqrt(distance2);
+        if (cosAngle <= cosOuter) return 0.0f;
+        if (cosAngle >= cosInner) return 1.0f;
+        float t = (cosAngle - cosOuter) / (cosInner - cosOuter);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    // Window falloff: 1 at the light, smoothly 0 at range (1 when unbounded)
+    float attenuation(float distance2) const {
+        if (range <= 0.0f || type == LightType::DIRECTIONAL) return 1.0f;
+        float x = distance2 / (range * range);
+        float w = std::fmax(0.0f, 1.0f - x * x);
+        return w * w;
+    }
+
+    // Distance beyond which the light adds less than kCutoff to a surface
+    // 0 = too dim to matter anywhere, infinity = unbounded
+    float influenceRadius() const {
+        float p = power();
+        if (p <= kCutoff) return 0.0f;
+        if (range <= 0.0f || type == LightType::DIRECTIONAL) return std::numeric_limits<float>::infinity();
+        // Solve power * attenuation(d^2) = kCutoff for d
+        return range * std::pow(1.0f - std::sqrt(kCutoff / p), 0.25f);
+    }
+
+    // Upper bound on the light's unattenuated contribution (diffuse ignores
+    // the light color, specular is tinted by it)
+    float power() const {
+        return intensity * std::fmax(1.0f, std::fmax(color.x, std::fmax(color.y, color.z)));
+    }
 
     // Get a random point on the area light surface (sphere)
     // Uses stratified sampling for better distribution
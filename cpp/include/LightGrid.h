@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Light.h"
+#include "AABB.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// Uniform grid over the influence spheres of lights with a finite range
+// Each cell lists the ranged lights whose sphere overlaps it, so a hit point
+// only visits lights that can reach its cell. Unbounded lights reach every
+// point and are kept in a separate list; lights too dim to matter are dropped.
+class LightGrid {
+public:
+    LightGrid() : res{0, 0, 0} {}
+
+    void build(const std::vector<Light>& lights) {
+        unbounded.clear();
+        ranged.clear();
+        cellStart.clear();
+        cellLights.clear();
+        influence2.assign(lights.size(), 0.0f);
+        bounds = AABB();
+
+        float radiusSum = 0.0f;
+        for (uint32_t i = 0; i < lights.size(); ++i) {
+            float r = lights[i].influenceRadius();
+            if (r <= 0.0f) continue;
+            if (std::isinf(r)) {
+                unbounded.push_back(i);
+                continue;
+            }
+            ranged.push_back(i);
+            influence2[i] = r * r;
+            bounds.expand(lights[i].position - Vec3(r, r, r));
+            bounds.expand(lights[i].position + Vec3(r, r, r));
+            radiusSum += r;
+        }
+
+        if (ranged.empty()) {
+            return;
+        }
+
+        // Cells about one average influence radius wide: each light covers ~8
+        float cellSize = radiusSum / ranged.size();
+        Vec3 extent = bounds.max - bounds.min;
+        for (int a = 0; a < 3; ++a) {
+            res[a] = std::max(1, std::min(kMaxResolution, static_cast<int>(std::ceil(extent[a] / cellSize))));
+            invCellSize[a] = res[a] / extent[a];
+        }
+
+        // Two passes into a flat (CSR) cell list: count, then fill
+        cellStart.assign(static_cast<size_t>(res[0]) * res[1] * res[2] + 1, 0);
+        for (uint32_t i : ranged) {
+            forEachCell(lights[i], [&](size_t cell) { ++cellStart[cell + 1]; });
+        }
+        for (size_t c = 1; c < cellStart.size(); ++c) {
+            cellStart[c] += cellStart[c - 1];
+        }
+        cellLights.resize(cellStart.back());
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (uint32_t i : ranged) {
+            forEachCell(lights[i], [&](size_t cell) { cellLights[cursor[cell]++] = i; });
+        }
+    }
+
+    // Lights without a range (shade every point)
+    const std::vector<uint32_t>& unboundedLights() const {
+        return unbounded;
+    }
+
+    // Ranged lights whose influence may reach p; confirm with reaches()
+    const uint32_t* query(const Vec3& p, uint32_t& count) const {
+        count = 0;
+        if (ranged.empty() ||
+            p.x < bounds.min.x || p.y < bounds.min.y || p.z < bounds.min.z ||
+            p.x > bounds.max.x || p.y > bounds.max.y || p.z > bounds.max.z) {
+            return nullptr;
+        }
+        size_t cell = cellIndex(cellCoord(p, 0), cellCoord(p, 1), cellCoord(p, 2));
+        count = cellStart[cell + 1] - cellStart[cell];
+        return cellLights.data() + cellStart[cell];
+    }
+
+    bool reaches(uint32_t light, float distance2) const {
+        return distance2 < influence2[light];
+    }
+
+private:
+    static constexpr int kMaxResolution = 32;
+
+    AABB bounds;
+    int res[3];
+    float invCellSize[3];
+    std::vector<uint32_t> unbounded;
+    std::vector<uint32_t> ranged;
+    std::vector<float> influence2;      // Squared influence radius per light
+    std::vector<uint32_t> cellStart;    // Offsets into cellLights, one per cell + 1
+    std::vector<uint32_t> cellLights;
+    std::vector<uint32_t> cursor;       // Build scratch: next free slot per cell
+
+    int cellCoord(const Vec3& p, int axis) const {
+        int c = static_cast<int>((p[axis] - bounds.min[axis]) * invCellSize[axis]);
+        return std::max(0, std::min(res[axis] - 1, c));
+    }
+
+    size_t cellIndex(int x, int y, int z) const {
+        return (static_cast<size_t>(z) * res[1] + y) * res[0] + x;
+    }
+
+    template <typename Fn>
+    void forEachCell(const Light& light, Fn fn) const {
+        float r = light.influenceRadius();
+        Vec3 lo = light.position - Vec3(r, r, r);
+        Vec3 hi = light.position + Vec3(r, r, r);
+        int x0 = cellCoord(lo, 0), x1 = cellCoord(hi, 0);
+        int y0 = cellCoord(lo, 1), y1 = cellCoord(hi, 1);
+        int z0 = cellCoord(lo, 2), z1 = cellCoord(hi, 2);
+        for (int z = z0; z <= z1; ++z) {
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    fn(cellIndex(x, y, z));
+                }
+            }
+        }
+    }
+};
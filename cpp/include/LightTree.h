@@ -0,0 +1,228 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Light.h"
+#include "BVH.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Light BVH for stochastic many-light sampling
+// Every node keeps the total power of its lights and the region their
+// influence can reach. sample() walks from the root to a leaf, choosing each
+// child with probability proportional to an importance estimate (power times
+// distance falloff times a cosine bound), so picking a light costs O(log N).
+// The returned pdf is the exact probability of the pick, which keeps
+// contribution / pdf unbiased.
+class LightTree {
+public:
+    void build(const std::vector<Light>& lights) {
+        lightPower.assign(lights.size(), 0.0f);
+        influence2.assign(lights.size(), 0.0f);
+
+        // Only lights that can contribute somewhere get a nonzero probability
+        active.clear();
+        bounds.clear();
+        for (uint32_t i = 0; i < lights.size(); ++i) {
+            float r = lights[i].influenceRadius();
+            if (r <= 0.0f) continue;
+            active.push_back(i);
+            lightPower[i] = lights[i].power();
+            influence2[i] = r * r;  // Infinite for unbounded lights
+
+            // Area lights get their true extent; points a small box so SAH has areas to compare
+            float e = std::fmax(lights[i].radius, 0.05f);
+            bounds.push_back(AABB(lights[i].position - Vec3(e, e, e), lights[i].position + Vec3(e, e, e)));
+        }
+
+        bvh.build(bounds, order);
+        for (uint32_t& index : order) {
+            index = active[index];
+        }
+
+        // Children follow their parent, so one backward pass sums power and reach
+        const std::vector<BVHNode>& nodes = bvh.nodes;
+        clusters.assign(nodes.size(), Cluster());
+        for (size_t n = nodes.size(); n-- > 0;) {
+            const BVHNode& node = nodes[n];
+            Cluster& cluster = clusters[n];
+            if (node.isLeaf()) {
+                for (uint32_t j = 0; j < node.count; ++j) {
+                    uint32_t index = order[node.leftFirst + j];
+                    const Light& light = lights[index];
+                    float r = std::sqrt(influence2[index]);
+                    if (std::isinf(r)) {
+                        cluster.unboundedPower += lightPower[index];
+                        cluster.reach = AABB(Vec3(-1e30f, -1e30f, -1e30f), Vec3(1e30f, 1e30f, 1e30f));
+                    } else {
+                        cluster.rangedPower += lightPower[index];
+                        cluster.maxRange = std::fmax(cluster.maxRange, light.range);
+                        cluster.reach.expand(AABB(light.position - Vec3(r, r, r), light.position + Vec3(r, r, r)));
+                    }
+                }
+            } else {
+                const Cluster& a = clusters[node.leftFirst];
+                const Cluster& b = clusters[node.leftFirst + 1];
+                cluster.unboundedPower = a.unboundedPower + b.unboundedPower;
+                cluster.rangedPower = a.rangedPower + b.rangedPower;
+                cluster.maxRange = std::fmax(a.maxRange, b.maxRange);
+                cluster.reach = a.reach;
+                cluster.reach.expand(b.reach);
+            }
+        }
+    }
+
+    bool empty() const {
+        return bvh.empty();
+    }
+
+    // Pick a light to shade point p (surface normal n) with one uniform
+    // number u in [0, 1). Returns the scene light index and its probability,
+    // or -1 when no light can reach p (every contribution there is zero)
+    int sample(const std::vector<Light>& lights, const Vec3& p, const Vec3& n, float u, float& pdf) const {
+        pdf = 1.0f;
+        if (bvh.empty() || importance(0, p, n) <= 0.0f) {
+            return -1;
+        }
+
+        const std::vector<BVHNode>& nodes = bvh.nodes;
+        uint32_t node = 0;
+        while (!nodes[node].isLeaf()) {
+            uint32_t left = nodes[node].leftFirst;
+            float wLeft = importance(left, p, n);
+            float wRight = importance(left + 1, p, n);
+            float total = wLeft + wRight;
+            if (total <= 0.0f) {
+                return -1;
+            }
+
+            // Reuse u for the next level by rescaling it into the chosen interval
+            float pLeft = wLeft / total;
+            if (u < pLeft) {
+                node = left;
+                pdf *= pLeft;
+                u = u / pLeft;
+            } else {
+                node = left + 1;
+                pdf *= 1.0f - pLeft;
+                u = (u - pLeft) / (1.0f - pLeft);
+            }
+            u = std::min(u, kOneMinusEpsilon);
+        }
+
+        // Leaf: choose among its lights by their exact falloff at p
+        const BVHNode& leaf = nodes[node];
+        float total = 0.0f;
+        for (uint32_t j = 0; j < leaf.count; ++j) {
+            total += lightImportance(lights, order[leaf.leftFirst + j], p, n);
+        }
+        if (total <= 0.0f) {
+            return -1;
+        }
+
+        float target = u * total;
+        float sum = 0.0f;
+        uint32_t chosen = order[leaf.leftFirst];
+        float weight = 0.0f;
+        for (uint32_t j = 0; j < leaf.count; ++j) {
+            uint32_t index = order[leaf.leftFirst + j];
+            float w = lightImportance(lights, index, p, n);
+            if (w <= 0.0f) continue;
+            chosen = index;
+            weight = w;
+            sum += w;
+            if (target < sum) break;
+        }
+
+        pdf *= weight / total;
+        return static_cast<int>(chosen);
+    }
+
+private:
+    static constexpr float kOneMinusEpsilon = 0.99999994f;
+
+    // Lights behind the surface still add specular and the 0.3 shadow term,
+    // so they keep a small nonzero weight (zero would bias the estimate)
+    static constexpr float kMinCosine = 0.05f;
+
+    // Ranged clusters are weighted by the falloff at their center; this share
+    // of the (upper bound) falloff at their nearest point keeps it nonzero
+    static constexpr float kMinFalloff = 0.1f;
+
+    static float window(float x) {
+        float w = std::fmax(0.0f, 1.0f - x * x);
+        return w * w;
+    }
+
+    // Per-node summary; unbounded lights have no distance falloff, so their
+    // power is kept apart from the ranged lights'
+    struct Cluster {
+        float unboundedPower;
+        float rangedPower;
+        float maxRange;
+        AABB reach;              // Union of the ranged lights' influence spheres
+
+        Cluster() : unboundedPower(0.0f), rangedPower(0.0f), maxRange(0.0f) {}
+    };
+
+    BVH bvh;
+    std::vector<uint32_t> order;        // Leaf ranges -> scene light indices
+    std::vector<Cluster> clusters;      // One per BVH node
+    std::vector<float> lightPower;
+    std::vector<float> influence2;      // Squared influence radius per light
+
+    // Build scratch, kept so a rebuild reuses its capacity
+    std::vector<uint32_t> active;       // Build-order index -> scene light index
+    std::vector<AABB> bounds;
+
+    // Cluster power times the falloff at its nearest possible light (an
+    // upper bound) times the cosine bound of the cone the cluster subtends
+    float importance(uint32_t node, const Vec3& p, const Vec3& n) const {
+        const Cluster& cluster = clusters[node];
+        const AABB& reach = cluster.reach;
+        if (p.x < reach.min.x || p.y < reach.min.y || p.z < reach.min.z ||
+            p.x > reach.max.x || p.y > reach.max.y || p.z > reach.max.z) {
+            return 0.0f;
+        }
+
+        const AABB& bounds = bvh.nodes[node].bounds;
+        Vec3 toCluster = bounds.centroid() - p;
+        float distance = toCluster.length();
+        float radius = 0.5f * (bounds.max - bounds.min).length();
+
+        float power = cluster.unboundedPower;
+        if (cluster.rangedPower > 0.0f) {
+            float invRange2 = 1.0f / (cluster.maxRange * cluster.maxRange);
+            float nearest = std::fmax(0.0f, distance - radius);
+            power += cluster.rangedPower * std::fmax(window(distance * distance * invRange2),
+                                                     kMinFalloff * window(nearest * nearest * invRange2));
+        }
+
+        // cos(max(0, theta - halfAngle)) without trig: theta is the angle
+        // from the normal to the cluster center, halfAngle its angular radius
+        float cosine = 1.0f;
+        if (distance > radius) {
+            float cosTheta = n.dot(toCluster) / distance;
+            float sinHalf = radius / distance;
+            float cosHalf = std::sqrt(1.0f - sinHalf * sinHalf);
+            if (cosTheta < cosHalf) {
+                float sinTheta = std::sqrt(std::fmax(0.0f, 1.0f - cosTheta * cosTheta));
+                cosine = cosTheta * cosHalf + sinTheta * sinHalf;
+            }
+        }
+        return power * std::fmax(kMinCosine, cosine);
+    }
+
+    float lightImportance(const std::vector<Light>& lights, uint32_t index, const Vec3& p, const Vec3& n) const {
+        const Light& light = lights[index];
+        Vec3 toLight = light.position - p;
+        float distance2 = toLight.lengthSquared();
+        if (distance2 >= influence2[index]) {
+            return 0.0f;
+        }
+        float cosine = std::fmax(kMinCosine, n.dot(light.directionFrom(p)));
+        return lightPower[index] * light.attenuation(distance2) * light.coneFactor(p) * cosine;
+    }
+};
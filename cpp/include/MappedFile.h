@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+
+#if !defined(__EMSCRIPTEN__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define RT_MMAP_FILES 1
+#endif
+
+// Read-only view of a file's bytes
+// Memory-mapped on native POSIX builds, read into a buffer elsewhere
+class MappedFile {
+public:
+    MappedFile() : mapped(nullptr), mappedSize(0) {}
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path) {
+        close();
+#ifdef RT_MMAP_FILES
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void* ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED) return false;
+
+        madvise(ptr, size, MADV_SEQUENTIAL);
+        mapped = static_cast<const uint8_t*>(ptr);
+        mappedSize = size;
+        return true;
+#else
+        FILE* file = std::fopen(path, "rb");
+        if (!file) return false;
+
+        uint8_t chunk[1 << 16];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        std::fclose(file);
+        return !buffer.empty();
+#endif
+    }
+
+    void close() {
+#ifdef RT_MMAP_FILES
+        if (mapped) {
+            munmap(const_cast<uint8_t*>(mapped), mappedSize);
+        }
+#endif
+        mapped = nullptr;
+        mappedSize = 0;
+        buffer.clear();
+    }
+
+    const uint8_t* data() const { return mapped ? mapped : buffer.data(); }
+    size_t size() const { return mapped ? mappedSize : buffer.size(); }
+
+private:
+    const uint8_t* mapped;
+    size_t mappedSize;
+    std::vector<uint8_t> buffer;
+};
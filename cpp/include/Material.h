@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Vec3.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 struct Material {
     Vec3 color;
@@ -73,5 +76,34 @@ struct Material {
         m.refractiveIndex = 1.33f;
         return m;
     }
+
+    bool operator==(const Material& o) const {
+        return color.x == o.color.x && color.y == o.color.y && color.z == o.color.z &&
+               ambient == o.ambient && diffuse == o.diffuse &&
+               specularIntensity == o.specularIntensity && shininess == o.shininess &&
+               reflectivity == o.reflectivity && transparency == o.transparency &&
+               refractiveIndex == o.refractiveIndex;
+    }
+
+    bool operator!=(const Material& o) const {
+        return !(*this == o);
+    }
+};
+
+// Hash for interning materials in Scene's material table
+struct MaterialHash {
+    size_t operator()(const Material& m) const {
+        const float fields[10] = {m.color.x, m.color.y, m.color.z, m.ambient, m.diffuse,
+                                  m.specularIntensity, m.shininess, m.reflectivity,
+                                  m.transparency, m.refractiveIndex};
+        // FNV-1a over the raw field bits
+        uint64_t h = 1469598103934665603ull;
+        for (float f : fields) {
+            uint32_t bits = 0;
+            if (f != 0.0f) std::memcpy(&bits, &f, sizeof(bits));  // -0 == +0
+            h = (h ^ bits) * 1099511628211ull;
+        }
+        return static_cast<size_t>(h);
+    }
 };
 
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Vec3.h"
+#include "Ray.h"
+#include "Sphere.h"  // For HitRecord
+#include "BVH.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <utility>
+
+// Per-ray setup for the watertight ray/triangle test (Woop, Benthin, Wald 2013)
+// The ray is sheared so it points down +z; triangles are then tested in 2D,
+// which gives no gaps or double hits along shared edges
+struct WatertightRay {
+    int kx, ky, kz;    // Axis permutation, kz = dominant direction axis
+    float sx, sy, sz;  // Shear constants
+
+    explicit WatertightRay(const Vec3& dir) {
+        float ax = std::abs(dir.x), ay = std::abs(dir.y), az = std::abs(dir.z);
+        kz = (ax > ay) ? (ax > az ? 0 : 2) : (ay > az ? 1 : 2);
+        kx = (kz + 1) % 3;
+        ky = (kx + 1) % 3;
+        if (dir[kz] < 0.0f) std::swap(kx, ky);  // Preserve winding
+
+        sx = dir[kx] / dir[kz];
+        sy = dir[ky] / dir[kz];
+        sz = 1.0f / dir[kz];
+    }
+};
+
+// Indexed triangle mesh with its own BVH
+// Triangles are reordered at build time to match the BVH leaf ranges
+struct Mesh {
+    std::vector<Vec3> vertices;
+    std::vector<uint32_t> indices;  // 3 per triangle
+    int materialId;                 // Index into Scene::materials
+    BVH bvh;
+
+    Mesh() : materialId(0) {}
+
+    size_t triangleCount() const {
+        return indices.size() / 3;
+    }
+
+    // (Re)build the BVH; call after filling vertices/indices
+    void build() {
+        size_t count = triangleCount();
+        std::vector<AABB> bounds(count);
+        for (size_t i = 0; i < count; ++i) {
+            bounds[i].expand(vertices[indices[i * 3 + 0]]);
+            bounds[i].expand(vertices[indices[i * 3 + 1]]);
+            bounds[i].expand(vertices[indices[i * 3 + 2]]);
+        }
+
+        std::vector<uint32_t> order;
+        bvh.build(bounds, order);
+
+        std::vector<uint32_t> sorted(indices.size());
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t* src = &indices[order[i] * 3];
+            sorted[i * 3 + 0] = src[0];
+            sorted[i * 3 + 1] = src[1];
+            sorted[i * 3 + 2] = src[2];
+        }
+        indices.swap(sorted);
+    }
+
+    // Closest hit closer than tMax
+    HitRecord intersect(const Ray& ray, float tMax = 1e30f) const {
+        HitRecord record;
+        WatertightRay wr(ray.direction);
+        uint32_t hitTriangle = 0;
+
+        bvh.traverse(ray, tMax, [&](uint32_t first, uint32_t count, float& tLimit) {
+            for (uint32_t i = first; i < first + count; ++i) {
+                float t;
+                if (intersectTriangle(ray, wr, i, tLimit, t)) {
+                    tLimit = t;
+                    hitTriangle = i;
+                    record.hit = true;
+                }
+            }
+            return false;
+        });
+
+        if (!record.hit) {
+            return record;
+        }
+
+        const Vec3& v0 = vertices[indices[hitTriangle * 3 + 0]];
+        const Vec3& v1 = vertices[indices[hitTriangle * 3 + 1]];
+        const Vec3& v2 = vertices[indices[hitTriangle * 3 + 2]];
+
+        record.t = tMax;
+        record.point = ray.at(tMax);
+        record.normal = (v1 - v0).cross(v2 - v0).normalize();  // Follows winding order
+        record.materialId = materialId;
+        return record;
+    }
+
+    // Any hit closer than maxT (shadow rays)
+    bool occluded(const Ray& ray, float maxT, uint32_t* blocker = nullptr) const {
+        WatertightRay wr(ray.direction);
+        bool hit = false;
+
+        bvh.traverse(ray, maxT, [&](uint32_t first, uint32_t count, float& tLimit) {
+            for (uint32_t i = first; i < first + count; ++i) {
+                float t;
+                if (intersectTriangle(ray, wr, i, tLimit, t)) {
+                    if (blocker) *blocker = i;
+                    hit = true;
+                    return true;
+                }
+            }
+            return false;
+        });
+
+        return hit;
+    }
+
+    // Single-triangle shadow test (e.g. a cached occluder)
+    bool occludedByTriangle(const Ray& ray, float maxT, uint32_t triangle) const {
+        if (triangle >= triangleCount()) return false;
+        float t;
+        return intersectTriangle(ray, WatertightRay(ray.direction), triangle, maxT, t);
+    }
+
+private:
+    bool intersectTriangle(const Ray& ray, const WatertightRay& wr, uint32_t tri, float tMax, float& tOut) const {
+        Vec3 a = vertices[indices[tri * 3 + 0]] - ray.origin;
+        Vec3 b = vertices[indices[tri * 3 + 1]] - ray.origin;
+        Vec3 c = vertices[indices[tri * 3 + 2]] - ray.origin;
+
+        float ax = a[wr.kx] - wr.sx * a[wr.kz];
+        float ay = a[wr.ky] - wr.sy * a[wr.kz];
+        float bx = b[wr.kx] - wr.sx * b[wr.kz];
+        float by = b[wr.ky] - wr.sy * b[wr.kz];
+        float cx = c[wr.kx] - wr.sx * c[wr.kz];
+        float cy = c[wr.ky] - wr.sy * c[wr.kz];
+
+        // Scaled barycentrics (2D edge functions)
+        float u = cx * by - cy * bx;
+        float v = ax * cy - ay * cx;
+        float w = bx * ay - by * ax;
+
+        // Exactly on an edge: redo in double so neighbours agree
+        if (u == 0.0f || v == 0.0f || w == 0.0f) {
+            u = static_cast<float>(static_cast<double>(cx) * by - static_cast<double>(cy) * bx);
+            v = static_cast<float>(static_cast<double>(ax) * cy - static_cast<double>(ay) * cx);
+            w = static_cast<float>(static_cast<double>(bx) * ay - static_cast<double>(by) * ax);
+        }
+
+        if ((u < 0.0f || v < 0.0f || w < 0.0f) && (u > 0.0f || v > 0.0f || w > 0.0f)) {
+            return false;
+        }
+
+        float det = u + v + w;
+        if (det == 0.0f) {
+            return false;
+        }
+
+        float az = wr.sz * a[wr.kz];
+        float bz = wr.sz * b[wr.kz];
+        float cz = wr.sz * c[wr.kz];
+        float t = (u * az + v * bz + w * cz) / det;
+
+        if (t <= 0.001f || t >= tMax) {
+            return false;
+        }
+
+        tOut = t;
+        return true;
+    }
+};
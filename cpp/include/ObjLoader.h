@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "TextParse.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// ============================================================================
+// Wavefront OBJ loader
+// ============================================================================
+//
+// Streams through the file once, reading only positions ("v") and faces
+// ("f"); normals, texture coordinates, groups and materials are skipped.
+// Face indices may be negative (relative) and use the v, v/vt, v//vn or
+// v/vt/vn forms. Polygons are triangulated as fans.
+
+namespace ObjFile {
+
+inline bool fail(std::string* error, const char* message) {
+    if (error) *error = message;
+    return false;
+}
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline void skipSpaces(const char*& p, const char* end) {
+    while (p < end && isSpace(*p)) ++p;
+}
+
+inline void skipLine(const char*& p, const char* end) {
+    while (p < end && *p != '\n') ++p;
+    if (p < end) ++p;
+}
+
+// Parse one face vertex ("7", "7/2", "7//3", "-1/2/3"); returns a 0-based position index
+inline bool readFaceIndex(const char*& p, const char* end, size_t vertexCount, uint32_t& out) {
+    int64_t index;
+    if (!TextParse::parseInt(p, end, index) || index == 0) return false;
+
+    // Skip the texture/normal references
+    while (p < end && (*p == '/' || *p == '-' || (*p >= '0' && *p <= '9'))) ++p;
+
+    int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(vertexCount) + index;
+    if (resolved < 0 || resolved >= static_cast<int64_t>(vertexCount)) return false;
+    out = static_cast<uint32_t>(resolved);
+    return true;
+}
+
+// Parse OBJ text into a mesh and build its BVH
+inline bool load(Mesh& mesh, const uint8_t* data, size_t size, std::string* error = nullptr) {
+    const char* p = reinterpret_cast<const char*>(data);
+    const char* end = p + size;
+
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    // Rough reservation from file size (a vertex line is ~30 bytes)
+    mesh.vertices.reserve(size / 64);
+    mesh.indices.reserve(size / 16);
+
+    std::vector<uint32_t> face;
+    while (p < end) {
+        skipSpaces(p, end);
+        if (p + 1 < end && p[0] == 'v' && isSpace(p[1])) {
+            p += 2;
+            float xyz[3];
+            for (int i = 0; i < 3; ++i) {
+                skipSpaces(p, end);
+                if (!TextParse::parseFloat(p, end, xyz[i])) return fail(error, "Malformed vertex");
+            }
+            mesh.vertices.push_back(Vec3(xyz[0], xyz[1], xyz[2]));
+        } else if (p + 1 < end && p[0] == 'f' && isSpace(p[1])) {
+            p += 2;
+            face.clear();
+            while (true) {
+                skipSpaces(p, end);
+                if (p >= end || *p == '\n' || *p == '#') break;
+                uint32_t index;
+                if (!readFaceIndex(p, end, mesh.vertices.size(), index)) {
+                    return fail(error, "Face references a missing vertex");
+                }
+                face.push_back(index);
+            }
+            if (face.size() < 3) return fail(error, "Face has fewer than 3 vertices");
+
+            for (size_t i = 1; i + 1 < face.size(); ++i) {
+                mesh.indices.push_back(face[0]);
+                mesh.indices.push_back(face[i]);
+                mesh.indices.push_back(face[i + 1]);
+            }
+        }
+        skipLine(p, end);
+    }
+
+    if (mesh.indices.empty()) {
+        return fail(error, "OBJ file contains no faces");
+    }
+
+    mesh.vertices.shrink_to_fit();
+    mesh.indices.shrink_to_fit();
+    mesh.build();
+    return true;
+}
+
+// Load from disk (native builds)
+inline bool loadFile(Mesh& mesh, const char* path, std::string* error = nullptr) {
+    MappedFile file;
+    if (!file.open(path)) return fail(error, "Could not read OBJ file");
+    return load(mesh, file.data(), file.size(), error);
+}
+
+} // namespace ObjFile
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define RT_PERF_COUNTERS 1
+#endif
+
+// Hardware event counters of the calling thread (Linux perf_event_open)
+// Used by the CLI benchmark to compare cache behaviour between settings.
+// Each event opens on its own, so a CPU or VM that lacks one still reports
+// the rest; open() fails only if none is available (no PMU, or
+// kernel.perf_event_paranoid too strict).
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES = 0,
+        INSTRUCTIONS,
+        CACHE_REFERENCES,  // Last-level cache accesses
+        CACHE_MISSES,      // Last-level cache misses
+        L1D_MISSES,        // L1 data cache read misses
+        EVENT_COUNT
+    };
+
+    PerfCounters() {
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            fds[i] = -1;
+        }
+    }
+
+    ~PerfCounters() {
+        close();
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* eventName(int event) {
+        static const char* const names[EVENT_COUNT] = {
+            "cycles", "instructions", "LLC refs", "LLC misses", "L1d misses"
+        };
+        return event >= 0 && event < EVENT_COUNT ? names[event] : "?";
+    }
+
+    bool open() {
+        close();
+        bool any = false;
+#if defined(RT_PERF_COUNTERS)
+        const uint32_t types[EVENT_COUNT] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE
+        };
+        const uint64_t configs[EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+        };
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[i];
+            attr.config = configs[i];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            any = any || fds[i] >= 0;
+        }
+#endif
+        return any;
+    }
+
+    bool available(int event) const {
+        return fds[event] >= 0;
+    }
+
+    void start() {
+#if defined(RT_PERF_COUNTERS)
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            if (fds[i] >= 0) {
+                ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+                ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() {
+#if defined(RT_PERF_COUNTERS)
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            if (fds[i] >= 0) {
+                ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // Count since start(), 0 for an unavailable event
+    uint64_t value(int event) const {
+        uint64_t count = 0;
+#if defined(RT_PERF_COUNTERS)
+        if (fds[event] >= 0 && read(fds[event], &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+#else
+        (void)event;
+#endif
+        return count;
+    }
+
+private:
+    int fds[EVENT_COUNT];
+
+    void close() {
+#if defined(RT_PERF_COUNTERS)
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            if (fds[i] >= 0) {
+                ::close(fds[i]);
+            }
+        }
+#endif
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            fds[i] = -1;
+        }
+    }
+};
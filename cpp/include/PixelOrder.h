@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+// Order in which the pixels of a tile are traced
+// Consecutive pixels along a space-filling curve are neighbours in 2D, so
+// their rays (and the reflection rays they spawn) touch the same objects and
+// BVH nodes while those are still in cache. Rows jump back across the tile
+// at the end of every row.
+enum class PixelOrder {
+    ROWS = 0,     // Row by row (the original order, kept for A/B comparisons)
+    MORTON = 1,   // Z-order: interleaved x/y bits
+    HILBERT = 2   // Hilbert curve: every step moves to an adjacent pixel
+};
+
+namespace pixelorder {
+
+// Position along a Morton curve -> (x, y)
+inline void mortonDecode(uint32_t d, uint32_t& x, uint32_t& y) {
+    x = 0;
+    y = 0;
+    for (int bit = 0; bit < 16; ++bit) {
+        x |= ((d >> (2 * bit)) & 1u) << bit;
+        y |= ((d >> (2 * bit + 1)) & 1u) << bit;
+    }
+}
+
+// Position along the Hilbert curve filling a side x side square (side a
+// power of two) -> (x, y)
+inline void hilbertDecode(uint32_t side, uint32_t d, uint32_t& x, uint32_t& y) {
+    x = 0;
+    y = 0;
+    for (uint32_t s = 1; s < side; s *= 2) {
+        uint32_t rx = 1u & (d / 2);
+        uint32_t ry = 1u & (d ^ rx);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            uint32_t t = x;
+            x = y;
+            y = t;
+        }
+        x += s * rx;
+        y += s * ry;
+        d /= 4;
+    }
+}
+
+// Pixel offsets of a Side x Side tile in the given order, packed as
+// x | y << 8; built once per order
+template <int Side>
+struct Table {
+    static_assert(Side > 0 && Side <= 256 && (Side & (Side - 1)) == 0, "tile side must be a power of two up to 256");
+
+    uint16_t offsets[Side * Side];
+
+    explicit Table(PixelOrder order) {
+        for (uint32_t d = 0; d < Side * Side; ++d) {
+            uint32_t x = d % Side;
+            uint32_t y = d / Side;
+            if (order == PixelOrder::MORTON) {
+                mortonDecode(d, x, y);
+            } else if (order == PixelOrder::HILBERT) {
+                hilbertDecode(Side, d, x, y);
+            }
+            offsets[d] = static_cast<uint16_t>(x | (y << 8));
+        }
+    }
+
+    static const Table& get(PixelOrder order) {
+        static const Table morton(PixelOrder::MORTON);
+        static const Table hilbert(PixelOrder::HILBERT);
+        static const Table rows(PixelOrder::ROWS);
+        return order == PixelOrder::MORTON ? morton : order == PixelOrder::HILBERT ? hilbert : rows;
+    }
+};
+
+}  // namespace pixelorder
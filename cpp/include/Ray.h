@@ -5,12 +5,27 @@
 struct Ray {
     Vec3 origin;
     Vec3 direction;
+    Vec3 invDirection;  // 1 / direction per axis (+-inf for axis-parallel rays)
+    int sign[3];        // 1 where the direction component is negative
 
-    Ray() : origin(), direction(Vec3(0, 0, 1)) {}
-    Ray(const Vec3& o, const Vec3& d) : origin(o), direction(d.normalize()) {}
+    Ray() : origin(), direction(Vec3(0, 0, 1)) { updateInverse(); }
+    Ray(const Vec3& o, const Vec3& d) : origin(o), direction(d.normalize()) { updateInverse(); }
 
     Vec3 at(float t) const {
         return origin + direction * t;
     }
-};
 
+    // Set a direction that is already unit length (e.g. a rotated one)
+    void setDirection(const Vec3& d) {
+        direction = d;
+        updateInverse();
+    }
+
+    // Done once per ray so slab tests never divide
+    void updateInverse() {
+        invDirection = Vec3(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+        sign[0] = invDirection.x < 0.0f;
+        sign[1] = invDirection.y < 0.0f;
+        sign[2] = invDirection.z < 0.0f;
+    }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Typed view into a RenderArena block (no ownership)
+// Has the subset of the std::vector interface the frame buffers use.
+template <typename T>
+struct ArenaSpan {
+    T* ptr;
+    size_t count;
+
+    ArenaSpan() : ptr(nullptr), count(0) {}
+    ArenaSpan(T* p, size_t n) : ptr(p), count(n) {}
+
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+};
+
+// Reusable memory pool for per-frame buffers
+// One block, sized up front for the largest frame (setMaxResolution), is
+// carved into the framebuffer, AOVs and scratch at the start of every frame
+// with a bump pointer, so steady-state frames never touch the heap. A frame
+// larger than the reservation grows the block once; `grows` counts it.
+class RenderArena {
+public:
+    uint32_t grows;  // Reallocations after the first reservation
+
+    RenderArena() : grows(0), base(nullptr), capacity(0), offset(0) {}
+
+    RenderArena(const RenderArena&) = delete;
+    RenderArena& operator=(const RenderArena&) = delete;
+
+    // Bytes a span of count Ts takes, including alignment padding
+    template <typename T>
+    static size_t bytesFor(size_t count) {
+        return (count * sizeof(T) + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    size_t getCapacity() const {
+        return capacity;
+    }
+
+    // Make room for frames of up to `bytes`; returns true if it allocated
+    // Spans handed out before are invalid afterwards
+    bool reserve(size_t bytes) {
+        if (bytes <= capacity) {
+            return false;
+        }
+        if (capacity > 0) {
+            ++grows;
+        }
+        // Left uninitialized: zero-filling a large arena is a visible stall at
+        // startup, and every frame writes its buffers before reading them
+        storage.reset();
+        storage.reset(new unsigned char[bytes + kAlignment]);
+        uintptr_t raw = reinterpret_cast<uintptr_t>(storage.get());
+        base = reinterpret_cast<unsigned char*>((raw + kAlignment - 1) & ~uintptr_t(kAlignment - 1));
+        capacity = bytes;
+        offset = 0;
+        return true;
+    }
+
+    // Start carving a frame of `bytes` (the sum of its bytesFor() sizes)
+    void beginFrame(size_t bytes) {
+        reserve(bytes);
+        offset = 0;
+    }
+
+    // Uninitialized span; the frame's beginFrame() must have counted it
+    template <typename T>
+    ArenaSpan<T> allocate(size_t count) {
+        size_t size = bytesFor<T>(count);
+        if (offset + size > capacity) {
+            return ArenaSpan<T>();
+        }
+        T* p = reinterpret_cast<T*>(base + offset);
+        offset += size;
+        return ArenaSpan<T>(p, count);
+    }
+
+private:
+    static constexpr size_t kAlignment = 64;  // Cache line, and enough for any SIMD load
+
+    std::unique_ptr<unsigned char[]> storage;
+    unsigned char* base;
+    size_t capacity;
+    size_t offset;
+};
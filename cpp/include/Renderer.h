@@ -1,10 +1,19 @@
 #pragma once
 
 #include "Scene.h"
+#include "GBuffer.h"
+#include "Denoiser.h"
+#include "RenderArena.h"
+#include "HeapStats.h"
+#include "TileScheduler.h"
+#include "PixelOrder.h"
+#include "Wavefront.h"
 #include <vector>
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
-#include <random>
+#include <cstring>
 
 // Anti-aliasing levels
 enum class AALevel {
@@ -13,17 +22,70 @@ enum class AALevel {
     AA_4X = 2     // 4x4 = 16 samples per pixel
 };
 
+// Result of an object pick under a pixel
+struct PickResult {
+    int type;    // ObjectType as int (0 = nothing hit)
+    int index;   // Index into the matching Scene vector, -1 if nothing hit
+
+    PickResult() : type(0), index(-1) {}
+    PickResult(ObjectType t, int i) : type(static_cast<int>(t)), index(i) {}
+};
+
 class Renderer {
 public:
     int width;
     int height;
     AALevel antiAliasing;
-    
-    // Random number generator for jittered sampling
-    std::mt19937 rng;
-    std::uniform_real_distribution<float> dist;
+    PixelOrder pixelOrder;  // Traversal within each tile
+
+    // Denoising (edge-aware à-trous filter guided by primary-hit features)
+    bool denoiseEnabled;
+    Denoiser denoiser;
+
+    // Breadth-first tracing, optionally with sorted bounce queues (see Wavefront.h)
+    bool wavefrontEnabled;
+    bool raySortingEnabled;
+
+    // Progressive accumulation: show the average of the frames since the last reset
+    bool accumulationEnabled;
 
-    Renderer() : width(512), height(512), antiAliasing(AALevel::NONE), rng(42), dist(0.0f, 1.0f) {}
+    // Auxiliary outputs (depth, normal, albedo, object/material IDs)
+    bool aovsEnabled;
+    GBuffer gbuffer;
+
+    // Frame buffers, carved from the arena at the start of every frame
+    RenderArena arena;
+    ArenaSpan<uint8_t> framebuffer;  // RGBA bytes of the last frame
+    ArenaSpan<float> colorBuffer;    // Linear RGB before quantization
+    uint64_t frameAllocations;       // Heap allocations during the last frame (see HeapStats.h)
+
+    // State of the last frame, used to decide if the G-buffer can answer picks
+    bool frameFeaturesValid;
+    unsigned int frameGeometryRevision;
+    Camera frameCamera;
+
+    Renderer()
+        : width(512)
+        , height(512)
+        , antiAliasing(AALevel::NONE)
+        , pixelOrder(PixelOrder::HILBERT)
+        , denoiseEnabled(false)
+        , wavefrontEnabled(false)
+        , raySortingEnabled(false)
+        , accumulationEnabled(false)
+        , aovsEnabled(false)
+        , frameAllocations(0)
+        , frameFeaturesValid(false)
+        , frameGeometryRevision(0)
+        , frameWriteFeatures(false)
+        , frameAllocationsBefore(0)
+        , progressiveStride(0)
+        , tilesX(0)
+        , tilesY(0)
+        , accumulatedFrames(0) {
+        workerShadowStats.resize(1);
+        wavefronts.resize(1);
+    }
 
     void setAntiAliasing(int level) {
         switch (level) {
@@ -58,65 +120,567 @@ public:
         }
     }
 
+    void setDenoise(bool enabled) {
+        denoiseEnabled = enabled;
+    }
+
+    bool getDenoise() const {
+        return denoiseEnabled;
+    }
+
+    void setDenoiseIterations(int iterations) {
+        denoiser.setIterations(iterations);
+    }
+
+    int getDenoiseIterations() const {
+        return denoiser.iterations;
+    }
+
+    // ------------------------------------------------------------------------
+    // Threads
+    // ------------------------------------------------------------------------
+    // Frames are split into kTileSize tiles and rendered by a TileScheduler.
+    // Tiles are handed out most expensive first, by the time each took in the
+    // previous frame (or, for a new tile grid, a probe of a few primary rays
+    // per tile), so slow tiles such as ones covering glass do not end up last.
+    // Each tile reseeds the random generator, so images do not depend on the
+    // thread count (only visibility cache fills can differ, see
+    // VisibilityCache.h).
+
+    static constexpr int kTileSize = 32;
+
+    // Render threads including the caller; 0 = one per hardware thread
+    // WebAssembly builds without pthreads always use 1
+    void setThreads(int count) {
+        scheduler.setThreadCount(count);
+        workerShadowStats.assign(scheduler.getThreadCount(), ShadowStats());
+        wavefronts.resize(scheduler.getThreadCount());
+    }
+
+    int getThreads() const {
+        return scheduler.getThreadCount();
+    }
+
+    // 0 = rows, 1 = Morton, 2 = Hilbert (see PixelOrder.h)
+    void setPixelOrder(int order) {
+        switch (order) {
+            case 0: pixelOrder = PixelOrder::ROWS; break;
+            case 1: pixelOrder = PixelOrder::MORTON; break;
+            default: pixelOrder = PixelOrder::HILBERT; break;
+        }
+    }
+
+    int getPixelOrder() const {
+        return static_cast<int>(pixelOrder);
+    }
+
+    // Trace each tile breadth-first (wavefront) instead of one pixel at a time
+    // Without soft shadows, light sampling or AA the image is identical;
+    // with them, random numbers are drawn in a different order
+    void setWavefront(bool enabled) {
+        wavefrontEnabled = enabled;
+    }
+
+    bool getWavefront() const {
+        return wavefrontEnabled;
+    }
+
+    // Wavefront only: sort each bounce level by direction and origin
+    void setRaySorting(bool enabled) {
+        raySortingEnabled = enabled;
+    }
+
+    bool getRaySorting() const {
+        return raySortingEnabled;
+    }
+
+    // Average every finished frame with the ones before it, each traced with
+    // fresh random numbers, so AA, soft shadows and stochastic bounces
+    // converge over frames. A size change restarts on its own; call
+    // resetAccumulation() after any other scene or setting change.
+    void setAccumulation(bool enabled) {
+        accumulationEnabled = enabled;
+        accumulatedFrames = 0;
+    }
+
+    bool getAccumulation() const {
+        return accumulationEnabled;
+    }
+
+    void resetAccumulation() {
+        accumulatedFrames = 0;
+    }
+
+    // Frames in the current average (0 when accumulation is off)
+    int getAccumulatedFrames() const {
+        return accumulatedFrames;
+    }
+
+    // Keep the G-buffer filled after every frame (for picking, compositing, etc.)
+    void setAOVs(bool enabled) {
+        aovsEnabled = enabled;
+    }
+
+    bool getAOVs() const {
+        return aovsEnabled;
+    }
+
+    // Find the object under pixel (x, y) of the last rendered frame
+    // O(1) lookup in the object-ID buffer when it still matches the scene,
+    // otherwise a single primary ray through the same point render() samples
+    PickResult pick(const Scene& scene, int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) {
+            return PickResult();
+        }
+
+        if (isFrameCurrent(scene) && gbuffer.width == width && gbuffer.height == height) {
+            int32_t id = gbuffer.objectId[y * width + x];
+            return PickResult(GBuffer::objectIdType(id), GBuffer::objectIdIndex(id));
+        }
+
+        Camera camera = scene.camera;
+        camera.setAspectRatio(static_cast<float>(width) / height);
+
+        float u = (2.0f * x / width - 1.0f);
+        float v = (1.0f - 2.0f * y / height);
+        HitRecord hit = scene.trace(camera.getRay(u, v));
+        if (!hit.hit) {
+            return PickResult();
+        }
+        return PickResult(hit.objectType, hit.objectIndex);
+    }
+
+    // Arena bytes one frame of w x h takes, with every optional buffer
+    static size_t frameBytes(int w, int h) {
+        size_t count = static_cast<size_t>(w) * h;
+        return RenderArena::bytesFor<uint8_t>(count * 4) + RenderArena::bytesFor<float>(count * 3) +
+               GBuffer::frameBytes(w, h) + Denoiser::frameBytes(w, h);
+    }
+
+    // Preallocate the arena for frames up to w x h, so later frames at or
+    // below that size allocate nothing; returns false for a bad size
+    bool setMaxResolution(int w, int h) {
+        if (w <= 0 || h <= 0) {
+            return false;
+        }
+        arena.reserve(frameBytes(w, h));
+        accumBuffer.reserve(static_cast<size_t>(w) * h * 3);
+        size_t tiles = static_cast<size_t>((w + kTileSize - 1) / kTileSize) * ((h + kTileSize - 1) / kTileSize);
+        tileCost.reserve(tiles);
+        tileTime.reserve(tiles);
+        tileOrder.reserve(tiles);
+        return true;
+    }
+
+    // Render into the arena; the returned RGBA view stays valid until the next frame
+    const ArenaSpan<uint8_t>& renderFrame(Scene& scene) {
+        beginFrame(scene);
+        renderTiles(scene, 1, 0);
+        endFrame(scene);
+        progressiveStride = 0;
+        return framebuffer;
+    }
+
+    // ------------------------------------------------------------------------
+    // Coarse-to-fine preview
+    // ------------------------------------------------------------------------
+    // A progressive frame renders every 8th pixel in each direction, then
+    // every 4th, 2nd and finally all of them. Each level traces only the
+    // pixels the coarser ones skipped and shows each traced pixel as a block,
+    // so the framebuffer always holds a full-size preview. The finished frame
+    // matches renderFrame() (with AA the jitter sequence differs). Scene edits
+    // between levels should restart with beginProgressive(). With
+    // accumulation on, the coarse levels show the new frame alone and the
+    // final level the average.
+
+    static constexpr int kCoarsestStride = 8;
+
+    // Start a progressive frame; renderNextLevel() does the work
+    void beginProgressive(Scene& scene) {
+        beginFrame(scene);
+        progressiveStride = kCoarsestStride * 2;
+    }
+
+    // Render the next level into the framebuffer (valid until the next call)
+    // Returns true while finer levels remain
+    bool renderNextLevel(Scene& scene) {
+        if (progressiveStride <= 1) {
+            return false;
+        }
+
+        int coarser = progressiveStride;
+        int stride = coarser / 2;
+        // Pixels on the coarser grid were traced by an earlier level
+        renderTiles(scene, stride, coarser <= kCoarsestStride ? coarser : 0);
+
+        progressiveStride = stride;
+        if (stride == 1) {
+            endFrame(scene);
+            return false;
+        }
+        writeBlocks(stride);
+        return true;
+    }
+
+    // Stride of the last finished level (1 = full frame), 0 when no
+    // progressive frame has been started since the last renderFrame()
+    int getProgressiveStride() const {
+        return progressiveStride > kCoarsestStride ? 0 : progressiveStride;
+    }
+
+    // Render and copy the frame out (one allocation per call; renderFrame() avoids it)
     std::vector<uint8_t> render(Scene& scene) {
-        std::vector<uint8_t> buffer(width * height * 4);
-        
+        const ArenaSpan<uint8_t>& pixels = renderFrame(scene);
+        return std::vector<uint8_t>(pixels.begin(), pixels.end());
+    }
+
+private:
+    // Per-frame state shared by renderFrame() and the progressive levels
+    bool frameWriteFeatures;
+    uint64_t frameAllocationsBefore;
+    int progressiveStride;  // Stride of the last finished level; kCoarsestStride * 2 = none yet
+
+    // Tile scheduling
+    TileScheduler scheduler;
+    int tilesX;
+    int tilesY;
+    std::vector<float> tileCost;    // Seconds each tile took last frame (or the probe estimate)
+    std::vector<float> tileTime;    // Seconds spent on each tile so far this frame
+    std::vector<uint32_t> tileOrder;
+    std::vector<ShadowStats> workerShadowStats;
+    std::vector<Wavefront> wavefronts;  // Per-worker queues, kept between frames
+
+    // Running sum of the accumulated frames (outside the arena: it outlives a frame)
+    std::vector<float> accumBuffer;
+    int accumulatedFrames;
+
+    using Clock = std::chrono::steady_clock;
+
+    // Carve the frame's buffers and bring the scene's caches up to date
+    void beginFrame(Scene& scene) {
+        frameAllocationsBefore = heapstats::allocations();
+
+        size_t count = static_cast<size_t>(width) * height;
+        arena.beginFrame(frameBytes(width, height));
+        framebuffer = arena.allocate<uint8_t>(count * 4);
+        colorBuffer = arena.allocate<float>(count * 3);
+        if (accumBuffer.size() != count * 3) {
+            accumulatedFrames = 0;
+        }
+
+        // The G-buffer is cleared below and only complete again once the
+        // full-resolution pass ends (endFrame), so pick() until then traces
+        frameFeaturesValid = false;
+
+        // Feature buffers are only written when something consumes them;
+        // otherwise they are bound empty, so nothing can read stale arena bytes
+        frameWriteFeatures = denoiseEnabled || aovsEnabled;
+        if (frameWriteFeatures) {
+            gbuffer.bind(arena, width, height);
+            gbuffer.clear();
+        } else {
+            gbuffer.bind(arena, 0, 0);
+        }
+
         scene.camera.setAspectRatio(static_cast<float>(width) / height);
+        scene.updateInstances();
+        scene.updateSpheres();
+        scene.updateLights();
+
+        int columns = (width + kTileSize - 1) / kTileSize;
+        int rows = (height + kTileSize - 1) / kTileSize;
+        if (columns != tilesX || rows != tilesY) {
+            tilesX = columns;
+            tilesY = rows;
+            probeTileCosts(scene);
+        }
+        std::fill(tileTime.begin(), tileTime.end(), 0.0f);
+        scene.resetShadowStats();
+    }
+
+    // Rough cost of each tile of a new grid: the time a few primary rays take
+    void probeTileCosts(const Scene& scene) {
+        size_t count = static_cast<size_t>(tilesX) * tilesY;
+        tileCost.assign(count, 0.0f);
+        tileTime.assign(count, 0.0f);
+        tileOrder.resize(count);
+
+        for (int tile = 0; tile < static_cast<int>(count); ++tile) {
+            int x0 = (tile % tilesX) * kTileSize;
+            int y0 = (tile / tilesX) * kTileSize;
+            Clock::time_point start = Clock::now();
+            // One ray at the centre of each quarter of the tile
+            for (int q = 0; q < 4; ++q) {
+                int x = std::min(x0 + kTileSize / 4 + (q & 1) * kTileSize / 2, width - 1);
+                int y = std::min(y0 + kTileSize / 4 + (q >> 1) * kTileSize / 2, height - 1);
+                float u = (2.0f * x / width - 1.0f);
+                float v = (1.0f - 2.0f * y / height);
+                scene.traceRay(scene.camera.getRay(u, v), 0);
+            }
+            tileCost[tile] = std::chrono::duration<float>(Clock::now() - start).count();
+        }
+    }
+
+    // Render the pixels on the stride grid (minus those on the skip grid, if
+    // any) with every worker, most expensive tiles first
+    void renderTiles(Scene& scene, int stride, int skip) {
+        int count = tilesX * tilesY;
+        for (int i = 0; i < count; ++i) {
+            tileOrder[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(tileOrder.begin(), tileOrder.end(), [this](uint32_t a, uint32_t b) {
+            return tileCost[a] > tileCost[b] || (tileCost[a] == tileCost[b] && a < b);
+        });
+
+        const Scene& shared = scene;
+        auto job = [&](int tile, int worker) {
+            Clock::time_point start = Clock::now();
+            renderTile(shared, tile, stride, skip, worker);
+            tileTime[tile] += std::chrono::duration<float>(Clock::now() - start).count();
+            workerShadowStats[worker].add(shared.takeThreadShadowStats());
+        };
+        scheduler.run(tileOrder.data(), count, job);
+
+        for (ShadowStats& stats : workerShadowStats) {
+            scene.addShadowStats(stats);
+            stats.reset();
+        }
+    }
+
+    void renderTile(const Scene& scene, int tile, int stride, int skip, int worker) {
+        // Same sequence whichever thread gets the tile; a new one for each
+        // accumulated frame
+        Scene::seedRandom(static_cast<uint32_t>(tile) * 0x9E3779B9u + static_cast<uint32_t>(stride) +
+                          static_cast<uint32_t>(accumulatedFrames) * 0x85EBCA6Bu);
+
+        if (wavefrontEnabled) {
+            renderTileWavefront(scene, tile, stride, skip, wavefronts[worker]);
+            return;
+        }
+        forEachTilePixel(tile, stride, skip, [&](int x, int y) {
+            renderPixel(scene, x, y);
+        });
+    }
+
+    // Visit the tile's pixels on the stride grid (minus those on the skip
+    // grid) in pixelOrder. The whole tile is walked along the curve: a curve
+    // restricted to a coarser grid still visits neighbours in turn, so
+    // progressive levels keep the locality.
+    template <typename Fn>
+    void forEachTilePixel(int tile, int stride, int skip, Fn fn) const {
+        int x0 = (tile % tilesX) * kTileSize;
+        int y0 = (tile / tilesX) * kTileSize;
+        int x1 = std::min(x0 + kTileSize, width);
+        int y1 = std::min(y0 + kTileSize, height);
+
+        const uint16_t* offsets = pixelorder::Table<kTileSize>::get(pixelOrder).offsets;
+        for (int i = 0; i < kTileSize * kTileSize; ++i) {
+            int x = x0 + (offsets[i] & 0xFF);
+            int y = y0 + (offsets[i] >> 8);
+            if (x >= x1 || y >= y1 || x % stride != 0 || y % stride != 0) {
+                continue;
+            }
+            if (skip > 0 && x % skip == 0 && y % skip == 0) {
+                continue;
+            }
+            fn(x, y);
+        }
+    }
 
+    // Queue every sample of the tile, trace them breadth-first, then average
+    // each pixel's samples in the same order renderPixel() sums them
+    void renderTileWavefront(const Scene& scene, int tile, int stride, int skip, Wavefront& wave) {
         int gridSize = getSampleGridSize();
-        int totalSamples = gridSize * gridSize;
-        float invSamples = 1.0f / static_cast<float>(totalSamples);
+        float invSamples = 1.0f / static_cast<float>(gridSize * gridSize);
         float subpixelSize = 1.0f / static_cast<float>(gridSize);
 
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                Vec3 colorAccum(0, 0, 0);
-
-                if (antiAliasing == AALevel::NONE) {
-                    // No AA - single sample at pixel center
-                    float u = (2.0f * x / width - 1.0f);
-                    float v = (1.0f - 2.0f * y / height);
-                    
-                    Ray ray = scene.camera.getRay(u, v);
-                    colorAccum = scene.traceRay(ray, 0);
-                } else {
-                    // Stratified sampling with jitter
-                    for (int sy = 0; sy < gridSize; ++sy) {
-                        for (int sx = 0; sx < gridSize; ++sx) {
-                            // Calculate subpixel offset with jitter
-                            float jitterX = dist(rng);
-                            float jitterY = dist(rng);
-                            
-                            // Position within pixel (0 to 1) with stratified jitter
-                            float subX = (sx + jitterX) * subpixelSize;
-                            float subY = (sy + jitterY) * subpixelSize;
-                            
-                            // Convert to normalized coordinates [-1, 1]
-                            float u = (2.0f * (x + subX) / width - 1.0f);
-                            float v = (1.0f - 2.0f * (y + subY) / height);
-                            
-                            Ray ray = scene.camera.getRay(u, v);
-                            Vec3 sampleColor = scene.traceRay(ray, 0);
-                            
-                            colorAccum = colorAccum + sampleColor;
-                        }
-                    }
-                    
-                    // Average all samples
-                    colorAccum = colorAccum * invSamples;
+        wave.begin();
+        forEachTilePixel(tile, stride, skip, [&](int x, int y) {
+            int featurePixel = frameWriteFeatures ? y * width + x : -1;
+            if (antiAliasing == AALevel::NONE) {
+                wave.addPrimary(pixelRay(scene, x, y), featurePixel, 1.0f);
+                return;
+            }
+            for (int sy = 0; sy < gridSize; ++sy) {
+                for (int sx = 0; sx < gridSize; ++sx) {
+                    wave.addPrimary(jitteredRay(scene, x, y, sx, sy, subpixelSize), featurePixel, invSamples);
+                }
+            }
+        });
+
+        wave.trace(scene, frameWriteFeatures ? &gbuffer : nullptr, raySortingEnabled);
+
+        uint32_t sample = 0;
+        forEachTilePixel(tile, stride, skip, [&](int x, int y) {
+            Vec3 colorAccum(0, 0, 0);
+            if (antiAliasing == AALevel::NONE) {
+                colorAccum = wave.sampleColor(sample++);
+            } else {
+                for (int s = 0; s < gridSize * gridSize; ++s) {
+                    colorAccum = colorAccum + wave.sampleColor(sample++);
+                }
+                colorAccum = colorAccum * invSamples;
+            }
+            storePixel(y * width + x, colorAccum);
+        });
+    }
+
+    // Ray through the corner of pixel (x, y) (no AA)
+    Ray pixelRay(const Scene& scene, int x, int y) const {
+        float u = (2.0f * x / width - 1.0f);
+        float v = (1.0f - 2.0f * y / height);
+        return scene.camera.getRay(u, v);
+    }
+
+    // Ray through a random point of subpixel cell (sx, sy)
+    Ray jitteredRay(const Scene& scene, int x, int y, int sx, int sy, float subpixelSize) const {
+        // Calculate subpixel offset with jitter
+        float jitterX = Scene::randomFloat();
+        float jitterY = Scene::randomFloat();
+
+        // Position within pixel (0 to 1) with stratified jitter
+        float subX = (sx + jitterX) * subpixelSize;
+        float subY = (sy + jitterY) * subpixelSize;
+
+        // Convert to normalized coordinates [-1, 1]
+        float u = (2.0f * (x + subX) / width - 1.0f);
+        float v = (1.0f - 2.0f * (y + subY) / height);
+        return scene.camera.getRay(u, v);
+    }
+
+    // Trace all samples of one pixel into colorBuffer (and the G-buffer)
+    void renderPixel(const Scene& scene, int x, int y) {
+        Vec3 colorAccum(0, 0, 0);
+        int pixel = y * width + x;
+        int featurePixel = frameWriteFeatures ? pixel : -1;
+
+        if (antiAliasing == AALevel::NONE) {
+            // No AA - single sample at pixel center
+            colorAccum = traceSample(scene, pixelRay(scene, x, y), featurePixel, 1.0f);
+        } else {
+            int gridSize = getSampleGridSize();
+            float invSamples = 1.0f / static_cast<float>(gridSize * gridSize);
+            float subpixelSize = 1.0f / static_cast<float>(gridSize);
+
+            // Stratified sampling with jitter
+            for (int sy = 0; sy < gridSize; ++sy) {
+                for (int sx = 0; sx < gridSize; ++sx) {
+                    Ray ray = jitteredRay(scene, x, y, sx, sy, subpixelSize);
+                    Vec3 sampleColor = traceSample(scene, ray, featurePixel, invSamples);
+
+                    colorAccum = colorAccum + sampleColor;
                 }
+            }
+
+            // Average all samples
+            colorAccum = colorAccum * invSamples;
+        }
+
+        storePixel(pixel, colorAccum);
+    }
+
+    // Quantized in one pass at the end (after the denoiser)
+    void storePixel(int pixel, const Vec3& color) {
+        colorBuffer[pixel * 3 + 0] = color.x;
+        colorBuffer[pixel * 3 + 1] = color.y;
+        colorBuffer[pixel * 3 + 2] = color.z;
+    }
+
+    // Denoise, quantize and record what the finished frame was rendered from
+    void endFrame(const Scene& scene) {
+        if (accumulationEnabled) {
+            accumulate();
+        }
+        if (denoiseEnabled) {
+            denoiser.apply(colorBuffer, gbuffer, arena);
+        }
+        writePixels();
 
-                // Clamp and write to buffer
-                Vec3 finalColor = colorAccum.clamp();
-                
-                int index = (y * width + x) * 4;
-                buffer[index + 0] = static_cast<uint8_t>(finalColor.x * 255.0f);
-                buffer[index + 1] = static_cast<uint8_t>(finalColor.y * 255.0f);
-                buffer[index + 2] = static_cast<uint8_t>(finalColor.z * 255.0f);
-                buffer[index + 3] = 255;
+        frameFeaturesValid = frameWriteFeatures;
+        frameGeometryRevision = scene.geometryRevision;
+        frameCamera = scene.camera;
+
+        frameAllocations = heapstats::allocations() - frameAllocationsBefore;
+        tileCost.swap(tileTime);
+    }
+
+    // Add the frame to the running sum and replace it with the average
+    void accumulate() {
+        size_t count = static_cast<size_t>(width) * height * 3;
+        if (accumulatedFrames == 0) {
+            accumBuffer.assign(count, 0.0f);
+        }
+        ++accumulatedFrames;
+        float invFrames = 1.0f / static_cast<float>(accumulatedFrames);
+        for (size_t i = 0; i < count; ++i) {
+            accumBuffer[i] += colorBuffer[i];
+            colorBuffer[i] = accumBuffer[i] * invFrames;
+        }
+    }
+
+    // Preview: fill each stride x stride block from its top-left pixel
+    void writeBlocks(int stride) {
+        for (int by = 0; by < height; by += stride) {
+            for (int bx = 0; bx < width; bx += stride) {
+                uint8_t rgba[4];
+                kernels::quantizeScalar(&colorBuffer[(static_cast<size_t>(by) * width + bx) * 3], rgba, 3);
+                rgba[3] = 255;
+
+                int yEnd = std::min(by + stride, height);
+                int xEnd = std::min(bx + stride, width);
+                for (int y = by; y < yEnd; ++y) {
+                    uint8_t* row = &framebuffer[(static_cast<size_t>(y) * width) * 4];
+                    for (int x = bx; x < xEnd; ++x) {
+                        std::memcpy(row + x * 4, rgba, 4);
+                    }
+                }
             }
         }
+    }
+
+    // True if the G-buffer was written for the scene's current geometry and view
+    bool isFrameCurrent(const Scene& scene) const {
+        const Camera& c = scene.camera;
+        return frameFeaturesValid &&
+               frameGeometryRevision == scene.geometryRevision &&
+               c.position.x == frameCamera.position.x &&
+               c.position.y == frameCamera.position.y &&
+               c.position.z == frameCamera.position.z &&
+               c.target.x == frameCamera.target.x &&
+               c.target.y == frameCamera.target.y &&
+               c.target.z == frameCamera.target.z &&
+               c.fov == frameCamera.fov;
+    }
+
+    // Trace one camera sample, recording primary-hit features when requested
+    Vec3 traceSample(const Scene& scene, const Ray& ray, int featurePixel, float weight) {
+        if (featurePixel < 0) {
+            return scene.traceRay(ray, 0);
+        }
 
-        return buffer;
+        HitRecord hit = scene.trace(ray);
+        if (!hit.hit) {
+            return scene.getBackgroundColor(ray);
+        }
+
+        gbuffer.accumulate(featurePixel, hit, weight);
+        return scene.shadeHit(ray, hit, 0);
+    }
+
+    // Clamp and quantize colorBuffer into the RGBA framebuffer
+    // The dispatched kernel packs RGB into the front of the buffer; spreading
+    // it to RGBA back to front never overwrites a byte still to be read
+    void writePixels() {
+        size_t count = static_cast<size_t>(width) * height;
+        cpuKernels().quantize(colorBuffer.data(), framebuffer.data(), count * 3);
+        for (size_t pixel = count; pixel-- > 0;) {
+            uint8_t r = framebuffer[pixel * 3 + 0];
+            uint8_t g = framebuffer[pixel * 3 + 1];
+            uint8_t b = framebuffer[pixel * 3 + 2];
+            framebuffer[pixel * 4 + 0] = r;
+            framebuffer[pixel * 4 + 1] = g;
+            framebuffer[pixel * 4 + 2] = b;
+            framebuffer[pixel * 4 + 3] = 255;
+        }
     }
 };
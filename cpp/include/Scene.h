@@ -6,11 +6,20 @@
 #include "Plane.h"
 #include "Box.h"
 #include "Cylinder.h"
+#include "Mesh.h"
+#include "Instance.h"
+#include "BVH.h"
 #include "Light.h"
+#include "LightGrid.h"
+#include "LightTree.h"
+#include "ShadowCache.h"
+#include "VisibilityCache.h"
+#include "Kernels.h"
 #include "Camera.h"
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <unordered_map>
 
 // Scene preset types
 enum class ScenePreset {
@@ -19,15 +28,29 @@ enum class ScenePreset {
     MIRROR_SPHERES = 2,
     RAINBOW = 3,
     GLASS_SPHERES = 4,
-    PRIMITIVES = 5
+    PRIMITIVES = 5,
+    CUSTOM = 6          // Loaded from a scene file
 };
 
 class Scene {
 public:
+    // Shared material table; primitives reference entries by index
+    std::vector<Material> materials;
+    std::unordered_map<Material, int, MaterialHash> materialLookup;
+
     std::vector<Sphere> spheres;
+    SphereBatch sphereBatch;           // Wide-kernel copy, rebuilt by updateSpheres()
     std::vector<Box> boxes;
     std::vector<Cylinder> cylinders;
+    std::vector<Mesh> meshes;          // Shared geometry, only drawn through instances
+    std::vector<Instance> instances;
+    BVH instanceBVH;                   // Top level: one leaf entry per instance
+    std::vector<uint32_t> instanceOrder;
+    bool instanceTreeDirty;            // Instances added/removed: rebuild
+    bool instanceBoundsDirty;          // Instances moved: refit
     std::vector<Light> lights;
+    LightGrid lightGrid;               // Rebuilt by updateLights()
+    LightTree lightTree;               // Many-light mode only
     Plane groundPlane;
     Camera camera;
     Vec3 backgroundColor;
@@ -39,21 +62,65 @@ public:
     // Soft shadow settings
     bool softShadowsEnabled;
     int shadowSamples;
+
+    // Many-light mode: lights sampled per hit (0 = shade every reachable light)
+    int lightSamples;
+
+    // Stochastic bounces: one Fresnel-picked branch per glass hit, and
+    // Russian roulette on paths whose throughput drops below kRouletteThroughput
+    bool stochasticBounces;
+    static constexpr float kRouletteThroughput = 0.1f;
+
+    // Optional shadow factor cache, reused while only the camera moves
+    bool visibilityCacheEnabled;
+    mutable VisibilityCache visibilityCache;
+
+    // Shadow ray counters of the last frame, summed by the renderer
+    ShadowStats shadowStats;
+    
+    // Bumped whenever primitives are added, removed or moved, so cached
+    // per-frame data (e.g. the object-ID buffer) can tell it is stale
+    unsigned int geometryRevision;
+
+    // Bumped whenever lights are added, removed or edited
+    unsigned int lightRevision;
+    unsigned int lightTreeRevision;  // lightRevision the light tree was built for
+    unsigned int lightGridRevision;  // lightRevision the light grid was built for
     
-    // Random number generator for soft shadows
-    mutable std::mt19937 rng;
-    mutable std::uniform_real_distribution<float> dist;
+    // Random numbers for soft shadows and light sampling: one generator per
+    // thread, reseeded by the renderer for each tile so the noise does not
+    // depend on how tiles were spread over threads
+    static std::mt19937& randomEngine() {
+        static thread_local std::mt19937 engine(42);
+        return engine;
+    }
+
+    static float randomFloat() {
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        return dist(randomEngine());
+    }
+
+    static void seedRandom(uint32_t seed) {
+        randomEngine().seed(seed);
+    }
 
     Scene() 
-        : backgroundColor(Vec3(0.05f, 0.05f, 0.08f))
+        : instanceTreeDirty(false)
+        , instanceBoundsDirty(false)
+        , backgroundColor(Vec3(0.05f, 0.05f, 0.08f))
         , horizonColor(Vec3(0.12f, 0.12f, 0.15f))
         , showGroundPlane(true)
         , maxReflectionDepth(5)
         , currentPreset(ScenePreset::SINGLE_SPHERE)
         , softShadowsEnabled(false)
         , shadowSamples(8)
-        , rng(42)
-        , dist(0.0f, 1.0f)
+        , lightSamples(0)
+        , stochasticBounces(false)
+        , visibilityCacheEnabled(false)
+        , geometryRevision(0)
+        , lightRevision(0)
+        , lightTreeRevision(~0u)
+        , lightGridRevision(~0u)
     {
         // Ground plane with subtle reflectivity
         groundPlane.material.reflectivity = 0.15f;
@@ -65,18 +132,168 @@ public:
         loadPreset(ScenePreset::SINGLE_SPHERE);
     }
 
+    // Add a material to the table, reusing an identical existing entry
+    int addMaterial(const Material& mat) {
+        auto it = materialLookup.find(mat);
+        if (it != materialLookup.end()) {
+            return it->second;
+        }
+        int id = static_cast<int>(materials.size());
+        materials.push_back(mat);
+        materialLookup.emplace(mat, id);
+        return id;
+    }
+
+    // Replace a material in place; every primitive referencing it sees the change
+    void setMaterial(int id, const Material& mat) {
+        if (id < 0 || id >= static_cast<int>(materials.size())) {
+            return;
+        }
+        auto it = materialLookup.find(materials[id]);
+        if (it != materialLookup.end() && it->second == id) {
+            materialLookup.erase(it);
+        }
+        materials[id] = mat;
+        materialLookup.emplace(mat, id);  // Keeps an existing identical entry
+    }
+
+    void clearMaterials() {
+        materials.clear();
+        materialLookup.clear();
+    }
+
+    int getMaterialCount() const {
+        return static_cast<int>(materials.size());
+    }
+
+    // Add shared mesh geometry (BVH already built) and return its index
+    // Nothing is drawn until an instance references it
+    int addMesh(Mesh&& mesh) {
+        meshes.push_back(std::move(mesh));
+        return static_cast<int>(meshes.size() - 1);
+    }
+
+    // Remove all meshes and their instances
+    void clearMeshes() {
+        if (!meshes.empty() || !instances.empty()) {
+            meshes.clear();
+            instances.clear();
+            instanceTreeDirty = true;
+            ++geometryRevision;
+        }
+    }
+
+    // ========================================
+    // Instances
+    // ========================================
+
+    // Place a mesh in the world; materialId -1 keeps the mesh's own material
+    int addInstance(int meshIndex, const Transform& xf, int materialId = -1) {
+        if (meshIndex < 0 || meshIndex >= static_cast<int>(meshes.size())) {
+            return -1;
+        }
+        instances.push_back(Instance(meshIndex, xf, materialId));
+        instances.back().updateBounds(meshes[meshIndex]);
+        instanceTreeDirty = true;
+        ++geometryRevision;
+        return static_cast<int>(instances.size() - 1);
+    }
+
+    void removeInstance(int index) {
+        if (index >= 0 && index < static_cast<int>(instances.size())) {
+            instances.erase(instances.begin() + index);
+            instanceTreeDirty = true;
+            ++geometryRevision;
+        }
+    }
+
+    // Moving an instance only refits the top level
+    void setInstanceTransform(int index, const Transform& xf) {
+        if (index >= 0 && index < static_cast<int>(instances.size())) {
+            Instance& inst = instances[index];
+            inst.setTransform(xf);
+            inst.updateBounds(meshes[inst.meshIndex]);
+            instanceBoundsDirty = true;
+            ++geometryRevision;
+        }
+    }
+
+    void setInstanceMaterial(int index, int materialId) {
+        if (index >= 0 && index < static_cast<int>(instances.size()) &&
+            materialId < static_cast<int>(materials.size())) {
+            instances[index].materialId = materialId;
+        }
+    }
+
+    int getInstanceCount() const {
+        return static_cast<int>(instances.size());
+    }
+
+    // Bring the top-level BVH up to date; call before tracing
+    void updateInstances() {
+        if (!instanceTreeDirty && !instanceBoundsDirty) {
+            return;
+        }
+        std::vector<AABB> bounds(instances.size());
+        for (size_t i = 0; i < instances.size(); ++i) {
+            bounds[i] = instances[i].bounds;
+        }
+        if (instanceTreeDirty) {
+            instanceBVH.build(bounds, instanceOrder);
+        } else {
+            instanceBVH.refit(bounds, instanceOrder);
+        }
+        instanceTreeDirty = false;
+        instanceBoundsDirty = false;
+    }
+
+    // Refresh the structure-of-arrays sphere copy the dispatched kernels
+    // read; until then trace() keeps to the per-sphere path
+    void updateSpheres() {
+        if (sphereBatch.revision != geometryRevision) {
+            sphereBatch.build(spheres, geometryRevision);
+        }
+    }
+
+    // Rebuild the light culling grid; call before shading (cheap, lights
+    // are edited directly through the vector so it is rebuilt every frame)
+    void updateLights() {
+        // Each structure is only rebuilt when the lights changed since its last build
+        if (useLightSampling()) {
+            if (lightTreeRevision != lightRevision) {
+                lightTree.build(lights);
+                lightTreeRevision = lightRevision;
+            }
+        } else if (lightGridRevision != lightRevision) {
+            lightGrid.build(lights);
+            lightGridRevision = lightRevision;
+        }
+        if (visibilityCacheEnabled) {
+            visibilityCache.validate(geometryRevision, lightRevision, softShadowsEnabled ? shadowSamples : 0);
+        }
+    }
+
+    // Sampling only pays off once there are more lights than samples
+    bool useLightSampling() const {
+        return lightSamples > 0 && static_cast<int>(lights.size()) > lightSamples;
+    }
+
     void loadPreset(ScenePreset preset) {
         currentPreset = preset;
+        ++geometryRevision;
+        ++lightRevision;
         spheres.clear();
         boxes.clear();
         cylinders.clear();
+        clearMeshes();
+        clearMaterials();
 
         switch (preset) {
             case ScenePreset::SINGLE_SPHERE: {
                 // Classic single red sphere
                 Material mat(Vec3(0.9f, 0.2f, 0.15f), 0.5f, 32.0f);
                 mat.reflectivity = 0.3f;
-                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, mat));
+                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, addMaterial(mat)));
                 break;
             }
 
@@ -84,17 +301,17 @@ public:
                 // Red sphere (center)
                 Material redMat(Vec3(0.9f, 0.2f, 0.15f), 0.6f, 64.0f);
                 redMat.reflectivity = 0.3f;
-                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, redMat));
+                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, addMaterial(redMat)));
 
                 // Blue sphere (left)
                 Material blueMat(Vec3(0.2f, 0.4f, 0.9f), 0.7f, 128.0f);
                 blueMat.reflectivity = 0.5f;
-                spheres.push_back(Sphere(Vec3(-2.2f, -0.3f, 0.5f), 0.7f, blueMat));
+                spheres.push_back(Sphere(Vec3(-2.2f, -0.3f, 0.5f), 0.7f, addMaterial(blueMat)));
 
                 // Green sphere (right)
                 Material greenMat(Vec3(0.2f, 0.85f, 0.3f), 0.5f, 48.0f);
                 greenMat.reflectivity = 0.2f;
-                spheres.push_back(Sphere(Vec3(2.0f, -0.5f, 1.0f), 0.5f, greenMat));
+                spheres.push_back(Sphere(Vec3(2.0f, -0.5f, 1.0f), 0.5f, addMaterial(greenMat)));
                 break;
             }
 
@@ -102,23 +319,23 @@ public:
                 // Chrome mirror sphere (center)
                 Material chromeMat(Vec3(0.95f, 0.95f, 0.95f), 1.0f, 256.0f);
                 chromeMat.reflectivity = 0.95f;
-                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, chromeMat));
+                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, addMaterial(chromeMat)));
 
                 // Gold sphere (left)
                 Material goldMat(Vec3(1.0f, 0.84f, 0.0f), 0.9f, 128.0f);
                 goldMat.reflectivity = 0.8f;
-                spheres.push_back(Sphere(Vec3(-2.0f, -0.4f, 0.3f), 0.6f, goldMat));
+                spheres.push_back(Sphere(Vec3(-2.0f, -0.4f, 0.3f), 0.6f, addMaterial(goldMat)));
 
                 // Rose gold sphere (right)
                 Material roseMat(Vec3(0.95f, 0.5f, 0.5f), 0.85f, 96.0f);
                 roseMat.reflectivity = 0.7f;
-                spheres.push_back(Sphere(Vec3(1.8f, -0.5f, 0.8f), 0.5f, roseMat));
+                spheres.push_back(Sphere(Vec3(1.8f, -0.5f, 0.8f), 0.5f, addMaterial(roseMat)));
 
                 // Small accent spheres
                 Material accentMat(Vec3(0.3f, 0.3f, 0.35f), 1.0f, 256.0f);
                 accentMat.reflectivity = 0.9f;
-                spheres.push_back(Sphere(Vec3(-0.8f, -0.75f, 1.5f), 0.25f, accentMat));
-                spheres.push_back(Sphere(Vec3(0.6f, -0.8f, 1.8f), 0.2f, accentMat));
+                spheres.push_back(Sphere(Vec3(-0.8f, -0.75f, 1.5f), 0.25f, addMaterial(accentMat)));
+                spheres.push_back(Sphere(Vec3(0.6f, -0.8f, 1.8f), 0.2f, addMaterial(accentMat)));
                 break;
             }
 
@@ -146,32 +363,28 @@ public:
                     float z = 0.5f + std::cos(i * 0.4f) * 0.5f;
                     float radius = 0.4f + (i == 3 ? 0.1f : 0.0f); // Bigger green center
                     
-                    spheres.push_back(Sphere(Vec3(x, y, z), radius, mat));
+                    spheres.push_back(Sphere(Vec3(x, y, z), radius, addMaterial(mat)));
                 }
                 break;
             }
 
             case ScenePreset::GLASS_SPHERES: {
                 // Large glass sphere (center)
-                Material glassMat = Material::glass();
-                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, glassMat));
+                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 1.0f, addMaterial(Material::glass())));
 
                 // Diamond sphere (left)
-                Material diamondMat = Material::diamond();
-                spheres.push_back(Sphere(Vec3(-2.0f, -0.4f, 0.5f), 0.6f, diamondMat));
+                spheres.push_back(Sphere(Vec3(-2.0f, -0.4f, 0.5f), 0.6f, addMaterial(Material::diamond())));
 
                 // Tinted glass sphere (right) - blue tint
-                Material blueTint = Material::glass(Vec3(0.85f, 0.9f, 1.0f));
-                spheres.push_back(Sphere(Vec3(1.8f, -0.5f, 0.8f), 0.5f, blueTint));
+                spheres.push_back(Sphere(Vec3(1.8f, -0.5f, 0.8f), 0.5f, addMaterial(Material::glass(Vec3(0.85f, 0.9f, 1.0f)))));
 
                 // Solid red sphere behind glass (to see refraction distortion)
                 Material redMat(Vec3(0.95f, 0.15f, 0.15f), 0.6f, 64.0f);
                 redMat.reflectivity = 0.2f;
-                spheres.push_back(Sphere(Vec3(0.0f, -0.3f, -2.5f), 0.7f, redMat));
+                spheres.push_back(Sphere(Vec3(0.0f, -0.3f, -2.5f), 0.7f, addMaterial(redMat)));
 
                 // Small water sphere
-                Material waterMat = Material::water();
-                spheres.push_back(Sphere(Vec3(-0.7f, -0.7f, 1.5f), 0.3f, waterMat));
+                spheres.push_back(Sphere(Vec3(-0.7f, -0.7f, 1.5f), 0.3f, addMaterial(Material::water())));
                 break;
             }
 
@@ -181,38 +394,41 @@ public:
                 // Central metallic sphere
                 Material sphereMat(Vec3(0.9f, 0.3f, 0.2f), 0.8f, 128.0f);
                 sphereMat.reflectivity = 0.4f;
-                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 0.8f, sphereMat));
+                spheres.push_back(Sphere(Vec3(0.0f, 0.0f, 0.0f), 0.8f, addMaterial(sphereMat)));
 
                 // Blue cube on the left
                 Material boxMat(Vec3(0.2f, 0.4f, 0.9f), 0.7f, 64.0f);
                 boxMat.reflectivity = 0.3f;
-                boxes.push_back(Box(Vec3(-2.2f, -0.35f, 0.3f), Vec3(1.3f, 1.3f, 1.3f), boxMat));
+                boxes.push_back(Box(Vec3(-2.2f, -0.35f, 0.3f), Vec3(1.3f, 1.3f, 1.3f), addMaterial(boxMat)));
 
                 // Green cylinder on the right
                 Material cylMat(Vec3(0.2f, 0.85f, 0.4f), 0.6f, 48.0f);
                 cylMat.reflectivity = 0.25f;
-                cylinders.push_back(Cylinder(Vec3(2.0f, -1.0f, 0.5f), 0.5f, 1.4f, cylMat));
+                cylinders.push_back(Cylinder(Vec3(2.0f, -1.0f, 0.5f), 0.5f, 1.4f, addMaterial(cylMat)));
 
                 // Small golden sphere behind
                 Material goldMat(Vec3(1.0f, 0.84f, 0.0f), 0.9f, 128.0f);
                 goldMat.reflectivity = 0.7f;
-                spheres.push_back(Sphere(Vec3(0.0f, -0.5f, -2.0f), 0.5f, goldMat));
+                spheres.push_back(Sphere(Vec3(0.0f, -0.5f, -2.0f), 0.5f, addMaterial(goldMat)));
 
                 // Glass cube in front right
-                Material glassMat = Material::glass();
-                boxes.push_back(Box(Vec3(1.0f, -0.6f, 1.8f), Vec3(0.8f, 0.8f, 0.8f), glassMat));
+                boxes.push_back(Box(Vec3(1.0f, -0.6f, 1.8f), Vec3(0.8f, 0.8f, 0.8f), addMaterial(Material::glass())));
 
                 // Purple cylinder behind left
                 Material purpleMat(Vec3(0.6f, 0.2f, 0.9f), 0.5f, 32.0f);
                 purpleMat.reflectivity = 0.2f;
-                cylinders.push_back(Cylinder(Vec3(-1.5f, -1.0f, -1.5f), 0.4f, 1.0f, purpleMat));
+                cylinders.push_back(Cylinder(Vec3(-1.5f, -1.0f, -1.5f), 0.4f, 1.0f, addMaterial(purpleMat)));
 
                 // Small mirror sphere accent
                 Material mirrorMat(Vec3(0.95f, 0.95f, 0.95f), 1.0f, 256.0f);
                 mirrorMat.reflectivity = 0.9f;
-                spheres.push_back(Sphere(Vec3(-0.7f, -0.75f, 1.5f), 0.25f, mirrorMat));
+                spheres.push_back(Sphere(Vec3(-0.7f, -0.75f, 1.5f), 0.25f, addMaterial(mirrorMat)));
                 break;
             }
+
+            case ScenePreset::CUSTOM:
+                // Populated by the SceneFile loaders
+                break;
         }
     }
 
@@ -222,68 +438,207 @@ public:
         closest.hit = false;
 
         // Test all spheres
-        for (const auto& sphere : spheres) {
-            HitRecord hit = sphere.intersect(ray);
-            if (hit.hit && hit.t < closest.t) {
-                closest = hit;
+        if (!useSphereBatch() || !traceSphereBatch(ray, closest)) {
+            for (size_t i = 0; i < spheres.size(); ++i) {
+                HitRecord hit = spheres[i].intersect(ray);
+                if (hit.hit && hit.t < closest.t) {
+                    closest = hit;
+                    closest.objectType = ObjectType::SPHERE;
+                    closest.objectIndex = static_cast<int>(i);
+                }
             }
         }
 
         // Test all boxes
-        for (const auto& box : boxes) {
-            HitRecord hit = box.intersect(ray);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            HitRecord hit = boxes[i].intersect(ray);
             if (hit.hit && hit.t < closest.t) {
                 closest = hit;
+                closest.objectType = ObjectType::BOX;
+                closest.objectIndex = static_cast<int>(i);
             }
         }
 
         // Test all cylinders
-        for (const auto& cylinder : cylinders) {
-            HitRecord hit = cylinder.intersect(ray);
+        for (size_t i = 0; i < cylinders.size(); ++i) {
+            HitRecord hit = cylinders[i].intersect(ray);
             if (hit.hit && hit.t < closest.t) {
                 closest = hit;
+                closest.objectType = ObjectType::CYLINDER;
+                closest.objectIndex = static_cast<int>(i);
             }
         }
 
+        // Test mesh instances through the top-level BVH
+        // (culled against the closest hit so far)
+        if (!instances.empty()) {
+            float tMax = closest.t;
+            instanceBVH.traverse(ray, tMax, [&](uint32_t first, uint32_t count, float& tLimit) {
+                for (uint32_t i = first; i < first + count; ++i) {
+                    uint32_t index = instanceOrder[i];
+                    const Instance& inst = instances[index];
+                    HitRecord hit = inst.intersect(meshes[inst.meshIndex], ray, tLimit);
+                    if (hit.hit && hit.t < tLimit) {
+                        tLimit = hit.t;
+                        closest = hit;
+                        closest.objectType = ObjectType::MESH;
+                        closest.objectIndex = static_cast<int>(index);
+                    }
+                }
+                return false;
+            });
+        }
+
         // Test ground plane
+        // It keeps its own material (the grid pattern recolors it per hit)
+        // and reports the first ID past the shared table
         if (showGroundPlane) {
             HitRecord planeHit = groundPlane.intersect(ray);
             if (planeHit.hit && planeHit.t < closest.t) {
                 closest = planeHit;
+                closest.objectType = ObjectType::PLANE;
+                closest.objectIndex = 0;
+                closest.materialId = static_cast<int>(materials.size());
+            }
+        }
+
+        // Resolve the material once, for the closest hit only
+        if (closest.hit && closest.objectType != ObjectType::PLANE) {
+            closest.material = materials[closest.materialId];
+
+            // Mesh normals follow winding order; face opaque ones toward the viewer
+            // (transparent meshes keep it so refraction can tell inside from outside)
+            if (closest.objectType == ObjectType::MESH && closest.material.transparency <= 0.001f &&
+                closest.normal.dot(ray.direction) > 0.0f) {
+                closest.normal = closest.normal * -1.0f;
             }
         }
 
         return closest;
     }
 
+    // Below this many spheres the per-sphere loop is as fast as the kernels
+    static constexpr size_t kSphereBatchMin = 8;
+
+    bool useSphereBatch() const {
+        return spheres.size() >= kSphereBatchMin && cpuKernels().nearestSphere &&
+               sphereBatch.revision == geometryRevision && sphereBatch.count == spheres.size();
+    }
+
+    bool traceSphereBatch(const Ray& ray, HitRecord& closest) const {
+        float tNearest;
+        int nearest = cpuKernels().nearestSphere(sphereBatch, ray, closest.t, tNearest);
+        if (nearest < 0) {
+            return true;
+        }
+
+        HitRecord hit = spheres[nearest].intersect(ray);
+        if (!hit.hit) {
+            return false;
+        }
+        closest = hit;
+        closest.objectType = ObjectType::SPHERE;
+        closest.objectIndex = nearest;
+        return true;
+    }
+
+    // Per-thread last-occluder hints and counters; see ShadowCache.h
+    static ShadowCache& shadowCache() {
+        static thread_local ShadowCache cache;
+        return cache;
+    }
+
     // Check if a point is in shadow (single ray - hard shadows)
-    bool isInShadowHard(const Vec3& point, const Vec3& lightPos) const {
+    // Given the light's index, its last occluder is tested before the full scan
+    bool isInShadowHard(const Vec3& point, const Vec3& lightPos, int lightIndex = -1) const {
         Vec3 toLight = lightPos - point;
         float lightDistance = toLight.length();
-        Vec3 lightDir = toLight.normalize();
-        
+        return isInShadowAlong(point, toLight.normalize(), lightDistance, lightIndex);
+    }
+
+    // Shadow ray along a unit direction up to lightDistance (infinite for
+    // directional lights, which block on any hit along the ray)
+    bool isInShadowAlong(const Vec3& point, const Vec3& lightDir, float lightDistance, int lightIndex = -1) const {
         Ray shadowRay(point + lightDir * 0.001f, lightDir);
-        
+
+        OccluderHint found;
+        if (lightIndex < 0) {
+            return findOccluder(shadowRay, lightDistance, found);
+        }
+
+        ShadowCache& cache = shadowCache();
+        OccluderHint& hint = cache.slot(lightIndex);
+        ++cache.stats.queries;
+        if (hint.type != ObjectType::NONE && isOccludedBy(hint, shadowRay, lightDistance)) {
+            ++cache.stats.occluded;
+            ++cache.stats.hintHits;
+            return true;
+        }
+        if (findOccluder(shadowRay, lightDistance, found)) {
+            ++cache.stats.occluded;
+            hint = found;
+            return true;
+        }
+        // Lit: drop the hint so the rest of a lit region doesn't pay for it
+        hint = OccluderHint();
+        return false;
+    }
+
+    // Full scan for any primitive blocking the ray before maxT
+    bool findOccluder(const Ray& shadowRay, float maxT, OccluderHint& found) const {
         // Check all spheres
-        for (const auto& sphere : spheres) {
-            HitRecord hit = sphere.intersect(shadowRay);
-            if (hit.hit && hit.t < lightDistance) {
+        if (useSphereBatch()) {
+            // Misses come back as kNoHit, so cap infinite (directional) maxT below it
+            int index = cpuKernels().firstSphereHit(sphereBatch, shadowRay, std::min(maxT, kernels::kNoHit));
+            if (index >= 0) {
+                found = OccluderHint(ObjectType::SPHERE, index);
                 return true;
             }
+        } else {
+            for (size_t i = 0; i < spheres.size(); ++i) {
+                HitRecord hit = spheres[i].intersect(shadowRay);
+                if (hit.hit && hit.t < maxT) {
+                    found = OccluderHint(ObjectType::SPHERE, static_cast<int>(i));
+                    return true;
+                }
+            }
         }
 
         // Check all boxes
-        for (const auto& box : boxes) {
-            HitRecord hit = box.intersect(shadowRay);
-            if (hit.hit && hit.t < lightDistance) {
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            HitRecord hit = boxes[i].intersect(shadowRay);
+            if (hit.hit && hit.t < maxT) {
+                found = OccluderHint(ObjectType::BOX, static_cast<int>(i));
                 return true;
             }
         }
 
         // Check all cylinders
-        for (const auto& cylinder : cylinders) {
-            HitRecord hit = cylinder.intersect(shadowRay);
-            if (hit.hit && hit.t < lightDistance) {
+        for (size_t i = 0; i < cylinders.size(); ++i) {
+            HitRecord hit = cylinders[i].intersect(shadowRay);
+            if (hit.hit && hit.t < maxT) {
+                found = OccluderHint(ObjectType::CYLINDER, static_cast<int>(i));
+                return true;
+            }
+        }
+
+        // Check mesh instances
+        if (!instances.empty()) {
+            bool blocked = false;
+            float tMax = maxT;
+            instanceBVH.traverse(shadowRay, tMax, [&](uint32_t first, uint32_t count, float&) {
+                for (uint32_t i = first; i < first + count; ++i) {
+                    const Instance& inst = instances[instanceOrder[i]];
+                    uint32_t triangle;
+                    if (inst.occluded(meshes[inst.meshIndex], shadowRay, maxT, &triangle)) {
+                        found = OccluderHint(ObjectType::MESH, static_cast<int>(instanceOrder[i]), triangle);
+                        blocked = true;
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (blocked) {
                 return true;
             }
         }
@@ -291,12 +646,66 @@ public:
         return false;
     }
 
+    // Test a single (possibly stale) occluder hint
+    bool isOccludedBy(const OccluderHint& hint, const Ray& shadowRay, float maxT) const {
+        size_t i = static_cast<size_t>(hint.index);
+        switch (hint.type) {
+            case ObjectType::SPHERE: {
+                if (i >= spheres.size()) return false;
+                HitRecord hit = spheres[i].intersect(shadowRay);
+                return hit.hit && hit.t < maxT;
+            }
+            case ObjectType::BOX: {
+                if (i >= boxes.size()) return false;
+                HitRecord hit = boxes[i].intersect(shadowRay);
+                return hit.hit && hit.t < maxT;
+            }
+            case ObjectType::CYLINDER: {
+                if (i >= cylinders.size()) return false;
+                HitRecord hit = cylinders[i].intersect(shadowRay);
+                return hit.hit && hit.t < maxT;
+            }
+            case ObjectType::MESH: {
+                if (i >= instances.size()) return false;
+                return instances[i].occludedByTriangle(meshes[instances[i].meshIndex], shadowRay, maxT, hint.triangle);
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Shadow ray counters of the last frame, summed over the render threads
+    const ShadowStats& getShadowStats() const {
+        return shadowStats;
+    }
+
+    void resetShadowStats() {
+        shadowStats.reset();
+        shadowCache().stats.reset();
+    }
+
+    void addShadowStats(const ShadowStats& stats) {
+        shadowStats.add(stats);
+    }
+
+    // Hand over the calling thread's counters since the last take
+    ShadowStats takeThreadShadowStats() const {
+        ShadowStats stats = shadowCache().stats;
+        shadowCache().stats.reset();
+        return stats;
+    }
+
     // Calculate shadow factor with soft shadows (area lights)
     // Returns 0.0 = fully in shadow, 1.0 = fully lit
-    float calculateShadowFactor(const Vec3& point, const Light& light) const {
+    float calculateShadowFactor(const Vec3& point, int lightIndex) const {
+        const Light& light = lights[lightIndex];
+        if (light.type == LightType::DIRECTIONAL) {
+            // No light position to sample: always one ray, no length limit
+            return isInShadowAlong(point, light.directionFrom(point), light.distanceFrom(point), lightIndex) ? 0.3f : 1.0f;
+        }
         if (!softShadowsEnabled || light.radius <= 0.0f) {
             // Hard shadows - simple binary test
-            return isInShadowHard(point, light.position) ? 0.3f : 1.0f;
+            return isInShadowHard(point, light.position, lightIndex) ? 0.3f : 1.0f;
         }
         
         // Soft shadows - multiple samples on the area light
@@ -310,14 +719,14 @@ public:
         for (int i = 0; i < sqrtSamples; ++i) {
             for (int j = 0; j < sqrtSamples; ++j) {
                 // Stratified random offset within each cell
-                float u = (i + dist(rng)) / sqrtSamples;
-                float v = (j + dist(rng)) / sqrtSamples;
+                float u = (i + randomFloat()) / sqrtSamples;
+                float v = (j + randomFloat()) / sqrtSamples;
                 
                 // Get sample point on area light (disk facing the point)
                 Vec3 samplePos = light.getSamplePointDisk(u, v, point);
                 
                 // Test shadow ray to this sample
-                if (!isInShadowHard(point, samplePos)) {
+                if (!isInShadowHard(point, samplePos, lightIndex)) {
                     litSamples++;
                 }
             }
@@ -341,20 +750,34 @@ public:
         Vec3 color(0, 0, 0);
         Vec3 viewDir = (ray.origin - hit.point).normalize();
 
-        for (const auto& light : lights) {
-            Vec3 lightDir = (light.position - hit.point).normalize();
-            
-            // Calculate shadow factor (soft or hard depending on settings)
-            float shadowFactor = calculateShadowFactor(hit.point, light);
-            
-            float diff = std::max(0.0f, hit.normal.dot(lightDir));
-            Vec3 diffuse = hit.material.color * diff * hit.material.diffuse;
-            
-            Vec3 halfDir = (lightDir + viewDir).normalize();
-            float spec = std::pow(std::max(0.0f, hit.normal.dot(halfDir)), hit.material.shininess);
-            Vec3 specular = light.color * spec * hit.material.specularIntensity;
-            
-            color = color + (diffuse + specular) * light.intensity * shadowFactor;
+        if (useLightSampling()) {
+            // Unbiased estimate of the sum over all lights: pick lightSamples
+            // lights by importance and weight each by 1 / (pdf * samples)
+            float invSamples = 1.0f / lightSamples;
+            for (int s = 0; s < lightSamples; ++s) {
+                float pdf;
+                int index = lightTree.sample(lights, hit.point, hit.normal, randomFloat(), pdf);
+                if (index < 0) continue;  // Picked a region no light reaches
+                float distance2 = (lights[index].position - hit.point).lengthSquared();
+                color = color + shadeLight(index, lights[index].attenuation(distance2), hit, viewDir) * (invSamples / pdf);
+            }
+            return color + hit.material.color * hit.material.ambient;
+        }
+
+        // Only lights that can reach the point are shaded: unbounded lights
+        // always, ranged ones from the grid cell when within their influence
+        for (uint32_t index : lightGrid.unboundedLights()) {
+            color = color + shadeLight(index, 1.0f, hit, viewDir);
+        }
+
+        uint32_t count;
+        const uint32_t* ranged = lightGrid.query(hit.point, count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const Light& light = lights[ranged[i]];
+            float distance2 = (light.position - hit.point).lengthSquared();
+            if (lightGrid.reaches(ranged[i], distance2)) {
+                color = color + shadeLight(ranged[i], light.attenuation(distance2), hit, viewDir);
+            }
         }
 
         Vec3 ambient = hit.material.color * hit.material.ambient;
@@ -363,6 +786,34 @@ public:
         return color;
     }
 
+    // Diffuse + specular from one light, scaled by its distance falloff
+    Vec3 shadeLight(int lightIndex, float attenuation, const HitRecord& hit, const Vec3& viewDir) const {
+        const Light& light = lights[lightIndex];
+
+        // Outside a spot cone the light adds nothing (not even the shadowed
+        // term), so reject before casting any shadow ray
+        float cone = light.coneFactor(hit.point);
+        if (cone <= 0.0f) {
+            return Vec3(0, 0, 0);
+        }
+        Vec3 lightDir = light.directionFrom(hit.point);
+
+        // Calculate shadow factor (soft or hard depending on settings)
+        float shadowFactor = visibilityCacheEnabled
+            ? visibilityCache.lookup(hit.point, hit.normal, lightIndex,
+                                     [&] { return calculateShadowFactor(hit.point, lightIndex); })
+            : calculateShadowFactor(hit.point, lightIndex);
+
+        float diff = std::max(0.0f, hit.normal.dot(lightDir));
+        Vec3 diffuse = hit.material.color * diff * hit.material.diffuse;
+
+        Vec3 halfDir = (lightDir + viewDir).normalize();
+        float spec = std::pow(std::max(0.0f, hit.normal.dot(halfDir)), hit.material.shininess);
+        Vec3 specular = light.color * spec * hit.material.specularIntensity;
+
+        return (diffuse + specular) * (light.intensity * attenuation * cone * shadowFactor);
+    }
+
     // Calculate Fresnel reflectance using Schlick's approximation
     float fresnel(float cosTheta, float n1, float n2) const {
         float r0 = (n1 - n2) / (n1 + n2);
@@ -371,7 +822,8 @@ public:
         return r0 + (1.0f - r0) * x * x * x * x * x;  // Schlick's approximation
     }
 
-    Vec3 traceRay(const Ray& ray, int depth) const {
+    // throughput: share of the pixel this ray carries (stochastic bounces only)
+    Vec3 traceRay(const Ray& ray, int depth, float throughput = 1.0f) const {
         if (depth >= maxReflectionDepth) {
             return getBackgroundColor(ray);
         }
@@ -382,6 +834,36 @@ public:
             return getBackgroundColor(ray);
         }
 
+        return shadeHit(ray, hit, depth, throughput);
+    }
+
+    // Russian roulette for a bounce carrying `throughput` of the pixel:
+    // returns the factor its color is scaled by, 0 if the path ends here.
+    // Paths above kRouletteThroughput always continue; below it they survive
+    // with probability throughput / kRouletteThroughput and are boosted by the
+    // inverse, which keeps the expected color.
+    static float rouletteWeight(float throughput) {
+        if (throughput >= kRouletteThroughput) {
+            return 1.0f;
+        }
+        float survival = throughput / kRouletteThroughput;
+        return randomFloat() < survival ? 1.0f / survival : 0.0f;
+    }
+
+    // Blend a hit's own lighting with a roulette-weighted bounce. The full
+    // tree clamps (base + bounce); clamping the boosted sum instead would
+    // cut the survivors and bias the average low, so only what the bounce
+    // adds on top of the clamped base is boosted. For a given bounce color
+    // the expectation is the full tree's clamped blend; a single sample can
+    // exceed 1 and is clamped when the frame is quantized.
+    static Vec3 rouletteBlend(const Vec3& base, const Vec3& bounce, float scale) {
+        Vec3 clampedBase = base.clamp();
+        return clampedBase + ((base + bounce).clamp() - clampedBase) * scale;
+    }
+
+    // Shade an already-traced hit (lighting + reflection/refraction bounces)
+    // Split out of traceRay so the renderer can record primary-hit features
+    Vec3 shadeHit(const Ray& ray, const HitRecord& hit, int depth, float throughput = 1.0f) const {
         Vec3 localColor = calculateLocalLighting(ray, hit);
         float transparency = hit.material.transparency;
         float reflectivity = hit.material.reflectivity;
@@ -422,6 +904,22 @@ public:
             Vec3 reflectDir = viewDir.reflect(normal);
             Vec3 reflectOrigin = hit.point + normal * 0.001f;
             Ray reflectRay(reflectOrigin, reflectDir);
+
+            if (stochasticBounces) {
+                // Follow one branch, picked with probability equal to its
+                // Fresnel weight, so the weight and the pick cancel out
+                bool reflect = totalInternalReflection || randomFloat() < fresnelReflect;
+                Vec3 tint = reflect ? Vec3(1.0f, 1.0f, 1.0f) : hit.material.color;
+                float next = throughput * transparency * std::fmax(tint.x, std::fmax(tint.y, tint.z));
+                float scale = rouletteWeight(next);
+                Vec3 transparentColor(0, 0, 0);
+                if (scale > 0.0f) {
+                    Ray bounce = reflect ? reflectRay : Ray(hit.point - normal * 0.001f, refractDir);
+                    transparentColor = traceRay(bounce, depth + 1, next * scale) * tint;
+                }
+                return rouletteBlend(localColor * (1.0f - transparency), transparentColor * transparency, scale);
+            }
+
             Vec3 reflectedColor = traceRay(reflectRay, depth + 1);
             
             if (totalInternalReflection) {
@@ -451,11 +949,21 @@ public:
             Vec3 reflectOrigin = hit.point + hit.normal * 0.001f;
             Ray reflectRay(reflectOrigin, reflectDir);
             
-            Vec3 reflectedColor = traceRay(reflectRay, depth + 1);
-            
             float cosTheta = std::abs(hit.normal.dot(viewDir * -1.0f));
             float fresnelFactor = reflectivity + (1.0f - reflectivity) * std::pow(1.0f - cosTheta, 3.0f);
             fresnelFactor = std::fmin(1.0f, fresnelFactor);
+
+            if (stochasticBounces) {
+                float next = throughput * fresnelFactor;
+                float scale = rouletteWeight(next);
+                Vec3 reflectedColor(0, 0, 0);
+                if (scale > 0.0f) {
+                    reflectedColor = traceRay(reflectRay, depth + 1, next * scale);
+                }
+                return rouletteBlend(localColor * (1.0f - fresnelFactor), reflectedColor * fresnelFactor, scale);
+            }
+
+            Vec3 reflectedColor = traceRay(reflectRay, depth + 1);
             
             localColor = localColor * (1.0f - fresnelFactor) + reflectedColor * fresnelFactor;
         }
@@ -464,39 +972,62 @@ public:
     }
 
     Vec3 shade(const Ray& ray, const HitRecord& hit) const {
-        return traceRay(ray, 0);
+        return shadeHit(ray, hit, 0);
     }
 
     // Update first sphere's material (for UI control)
+    // Edits the shared table entry, so every primitive using it changes too
     void updateMainSphere(float specular, float shininess, float reflectivity) {
         if (!spheres.empty()) {
-            spheres[0].material.specularIntensity = specular;
-            spheres[0].material.shininess = shininess;
-            spheres[0].material.reflectivity = reflectivity;
+            Material mat = materials[spheres[0].materialId];
+            mat.specularIntensity = specular;
+            mat.shininess = shininess;
+            mat.reflectivity = reflectivity;
+            setMaterial(spheres[0].materialId, mat);
         }
     }
 
     // Update first sphere's transparency/refraction properties
     void updateMainSphereTransparency(float transparency, float refractiveIndex) {
         if (!spheres.empty()) {
-            spheres[0].material.transparency = std::fmax(0.0f, std::fmin(1.0f, transparency));
-            spheres[0].material.refractiveIndex = std::fmax(1.0f, std::fmin(3.0f, refractiveIndex));
+            Material mat = materials[spheres[0].materialId];
+            mat.transparency = std::fmax(0.0f, std::fmin(1.0f, transparency));
+            mat.refractiveIndex = std::fmax(1.0f, std::fmin(3.0f, refractiveIndex));
+            setMaterial(spheres[0].materialId, mat);
         }
     }
 
     // Get current transparency of main sphere
     float getMainSphereTransparency() const {
-        return spheres.empty() ? 0.0f : spheres[0].material.transparency;
+        return spheres.empty() ? 0.0f : materials[spheres[0].materialId].transparency;
     }
 
     // Get current refractive index of main sphere
     float getMainSphereRefractiveIndex() const {
-        return spheres.empty() ? 1.0f : spheres[0].material.refractiveIndex;
+        return spheres.empty() ? 1.0f : materials[spheres[0].materialId].refractiveIndex;
     }
 
     void updateSphereColor(float r, float g, float b) {
         if (!spheres.empty()) {
-            spheres[0].material.color = Vec3(r, g, b);
+            Material mat = materials[spheres[0].materialId];
+            mat.color = Vec3(r, g, b);
+            setMaterial(spheres[0].materialId, mat);
+        }
+    }
+
+    // Rotate a box about its center (Euler angles in degrees)
+    void setBoxRotation(int index, float rx, float ry, float rz) {
+        if (index >= 0 && index < static_cast<int>(boxes.size())) {
+            boxes[index].setRotation(Vec3(rx, ry, rz));
+            ++geometryRevision;
+        }
+    }
+
+    // Rotate a cylinder about its base center (Euler angles in degrees)
+    void setCylinderRotation(int index, float rx, float ry, float rz) {
+        if (index >= 0 && index < static_cast<int>(cylinders.size())) {
+            cylinders[index].setRotation(Vec3(rx, ry, rz));
+            ++geometryRevision;
         }
     }
 
@@ -511,12 +1042,14 @@ public:
     void updateLight(float x, float y, float z) {
         if (!lights.empty()) {
             lights[0].position = Vec3(x, y, z);
+            ++lightRevision;
         }
     }
 
     // Add a new light to the scene
     int addLight(float x, float y, float z, float r, float g, float b, float intensity) {
         lights.push_back(Light(Vec3(x, y, z), Vec3(r, g, b), intensity));
+        ++lightRevision;
         return static_cast<int>(lights.size() - 1);
     }
 
@@ -524,6 +1057,7 @@ public:
     void removeLight(int index) {
         if (index >= 0 && index < static_cast<int>(lights.size()) && lights.size() > 1) {
             lights.erase(lights.begin() + index);
+            ++lightRevision;
         }
     }
 
@@ -531,6 +1065,7 @@ public:
     void setLightPosition(int index, float x, float y, float z) {
         if (index >= 0 && index < static_cast<int>(lights.size())) {
             lights[index].position = Vec3(x, y, z);
+            ++lightRevision;
         }
     }
 
@@ -538,6 +1073,7 @@ public:
     void setLightColor(int index, float r, float g, float b) {
         if (index >= 0 && index < static_cast<int>(lights.size())) {
             lights[index].color = Vec3(r, g, b);
+            ++lightRevision;
         }
     }
 
@@ -545,6 +1081,7 @@ public:
     void setLightIntensity(int index, float intensity) {
         if (index >= 0 && index < static_cast<int>(lights.size())) {
             lights[index].intensity = std::fmax(0.0f, std::fmin(2.0f, intensity));
+            ++lightRevision;
         }
     }
 
@@ -580,6 +1117,7 @@ public:
     void resetLights() {
         lights.clear();
         lights.push_back(Light(Vec3(2.0f, 3.0f, -2.0f), Vec3(1.0f, 1.0f, 1.0f), 1.0f));
+        ++lightRevision;
     }
 
     void updateCamera(float posX, float posY, float posZ) {
@@ -596,7 +1134,10 @@ public:
     }
 
     void setShowGroundPlane(bool show) {
-        showGroundPlane = show;
+        if (showGroundPlane != show) {
+            showGroundPlane = show;
+            ++geometryRevision;
+        }
     }
 
     void setGridScale(float scale) {
@@ -623,8 +1164,19 @@ public:
         return static_cast<int>(cylinders.size());
     }
 
+    int getMeshCount() const {
+        return static_cast<int>(meshes.size());
+    }
+
+    // Unique triangles (instances share their mesh's triangles)
+    int getTriangleCount() const {
+        size_t count = 0;
+        for (const auto& mesh : meshes) count += mesh.triangleCount();
+        return static_cast<int>(count);
+    }
+
     int getTotalObjectCount() const {
-        return static_cast<int>(spheres.size() + boxes.size() + cylinders.size());
+        return static_cast<int>(spheres.size() + boxes.size() + cylinders.size() + instances.size());
     }
 
     // Camera FOV and target
@@ -664,10 +1216,121 @@ public:
     void setLightRadius(int index, float radius) {
         if (index >= 0 && index < static_cast<int>(lights.size())) {
             lights[index].radius = std::fmax(0.0f, std::fmin(2.0f, radius));
+            ++lightRevision;
         }
     }
 
     float getLightRadius(int index) const {
         return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].radius : 0.5f;
     }
+
+    // Many-light mode: estimate lighting from this many importance-sampled
+    // lights per hit instead of shading all of them (0 = off)
+    void setLightSamples(int samples) {
+        lightSamples = std::max(0, std::min(16, samples));
+    }
+
+    int getLightSamples() const {
+        return lightSamples;
+    }
+
+    // Stochastic bounces: each glass hit follows reflection OR refraction,
+    // and dim paths end by Russian roulette, so a sample costs one ray per
+    // bounce instead of a tree that doubles at every glass hit. Each frame
+    // is noisy; accumulate frames (Renderer::setAccumulation) to converge
+    // on the full-tree image (see rouletteBlend for how boosted samples
+    // avoid the per-hit clamp).
+    void setStochasticBounces(bool enabled) {
+        stochasticBounces = enabled;
+    }
+
+    bool getStochasticBounces() const {
+        return stochasticBounces;
+    }
+
+    // Reuse shadow factors across frames while geometry and lights stay put
+    void setVisibilityCache(bool enabled) {
+        visibilityCacheEnabled = enabled;
+        if (!enabled) {
+            visibilityCache.clear();
+        }
+    }
+
+    bool getVisibilityCache() const {
+        return visibilityCacheEnabled;
+    }
+
+    // Cache resolution in world units; smaller = sharper shadows, more misses
+    void setVisibilityCacheCellSize(float size) {
+        visibilityCache.setCellSize(std::fmax(0.001f, std::fmin(1.0f, size)));
+    }
+
+    // Influence range with smooth falloff; 0 = unbounded (no falloff)
+    void setLightRange(int index, float range) {
+        if (index >= 0 && index < static_cast<int>(lights.size())) {
+            lights[index].range = std::fmax(0.0f, std::fmin(1000.0f, range));
+            ++lightRevision;
+        }
+    }
+
+    float getLightRange(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].range : 0.0f;
+    }
+
+    // 0 = point, 1 = directional, 2 = spot (see LightType)
+    void setLightType(int index, int type) {
+        if (index >= 0 && index < static_cast<int>(lights.size())) {
+            lights[index].type = static_cast<LightType>(std::max(0, std::min(2, type)));
+            ++lightRevision;
+        }
+    }
+
+    int getLightType(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? static_cast<int>(lights[index].type) : 0;
+    }
+
+    // Direction the light shines along (directional and spot lights)
+    void setLightDirection(int index, float x, float y, float z) {
+        Vec3 dir(x, y, z);
+        if (index >= 0 && index < static_cast<int>(lights.size()) && dir.lengthSquared() > 1e-12f) {
+            lights[index].direction = dir.normalize();
+            ++lightRevision;
+        }
+    }
+
+    float getLightDirectionX(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].direction.x : 0.0f;
+    }
+    float getLightDirectionY(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].direction.y : -1.0f;
+    }
+    float getLightDirectionZ(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].direction.z : 0.0f;
+    }
+
+    // Spot cone half-angle in degrees
+    void setLightSpotAngle(int index, float degrees) {
+        if (index >= 0 && index < static_cast<int>(lights.size())) {
+            lights[index].spotAngle = std::fmax(1.0f, std::fmin(90.0f, degrees));
+            lights[index].update();
+            ++lightRevision;
+        }
+    }
+
+    float getLightSpotAngle(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].spotAngle : 30.0f;
+    }
+
+    // Share of the spot cone that fades out toward its edge (0 = hard edge)
+    void setLightSpotSoftness(int index, float softness) {
+        if (index >= 0 && index < static_cast<int>(lights.size())) {
+            lights[index].spotSoftness = std::fmax(0.0f, std::fmin(1.0f, softness));
+            lights[index].update();
+            ++lightRevision;
+        }
+    }
+
+    float getLightSpotSoftness(int index) const {
+        return (index >= 0 && index < static_cast<int>(lights.size())) ? lights[index].spotSoftness : 0.2f;
+    }
 };
@@ -0,0 +1,703 @@
+#pragma once
+
+#include "Scene.h"
+#include "MappedFile.h"
+#include "TextParse.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <climits>
+
+// ============================================================================
+// Scene file formats
+// ============================================================================
+//
+// Binary (.rtsc) - little-endian, every field 4 bytes so records can be read
+// straight out of a memory-mapped file:
+//
+//   Header     magic "RTSC", u32 version, u32 flags,
+//              u32 materialCount, sphereCount, boxCount, cylinderCount, lightCount
+//   Camera     (flags & 1) position[3], target[3], fov
+//   Materials  color[3], ambient, diffuse, specularIntensity, shininess,
+//              reflectivity, transparency, refractiveIndex
+//   Spheres    center[3], radius, u32 material
+//   Boxes      center[3], size[3], u32 material, rotation[3]
+//   Cylinders  center[3], radius, height, u32 material, u32 capped, rotation[3]
+//   Lights     position[3], color[3], intensity, radius, range,
+//              u32 type, direction[3], spotAngle, spotSoftness
+//
+// Rotations are Euler angles in degrees. Version 1 files have no rotation
+// fields, versions 1-2 no light range (0 = unbounded) and versions 1-3 only
+// point lights; all still load.
+//
+// JSON - same content, e.g.
+//
+//   { "camera": { "position": [0, 1, -4], "target": [0, 0, 0], "fov": 60 },
+//     "materials": [ { "color": [0.9, 0.2, 0.15], "reflectivity": 0.3 } ],
+//     "spheres": [ { "center": [0, 0, 0], "radius": 1, "material": 0 } ],
+//     "boxes": [ { "center": [-2, 0, 0], "size": [1, 1, 1], "rotation": [0, 45, 0] } ],
+//     "cylinders": [ { "center": [2, -1, 0], "radius": 0.5, "height": 1.4, "axis": [1, 1, 0] } ],
+//     "lights": [ { "position": [2, 3, -2], "intensity": 1, "range": 8 },
+//                 { "type": "spot", "position": [0, 4, 0], "direction": [0, -1, 0],
+//                   "angle": 25, "softness": 0.3 } ],
+//     "groundPlane": true }
+//
+// Missing material fields keep the Material() defaults. File materials are
+// interned into Scene::materials, so duplicates collapse to one entry.
+//
+// The binary loader checks every material index and light type, then
+// streams records directly into the Scene's vectors. The JSON loader parses
+// into temporaries, rejecting unknown light types, and checks every
+// material reference. Either way, a file
+// that fails to load leaves the scene untouched.
+
+namespace SceneFile {
+
+static const char kMagic[4] = {'R', 'T', 'S', 'C'};
+static const uint32_t kVersion = 4;
+static const uint32_t kFlagCamera = 1;
+
+static const size_t kHeaderSize = 32;
+static const size_t kCameraSize = 7 * 4;
+static const size_t kMaterialSize = 10 * 4;
+static const size_t kSphereSize = 5 * 4;
+static const size_t kBoxSize = 10 * 4;
+static const size_t kCylinderSize = 10 * 4;
+static const size_t kBoxSizeV1 = 7 * 4;
+static const size_t kCylinderSizeV1 = 7 * 4;
+static const size_t kLightSize = 15 * 4;
+static const size_t kLightSizeV3 = 9 * 4;
+static const size_t kLightSizeV2 = 8 * 4;
+
+// ----------------------------------------------------------------------------
+// Binary helpers
+// ----------------------------------------------------------------------------
+
+inline uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline float readF32(const uint8_t* p) {
+    uint32_t bits = readU32(p);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline Vec3 readVec3(const uint8_t* p) {
+    return Vec3(readF32(p), readF32(p + 4), readF32(p + 8));
+}
+
+inline void writeU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 24));
+}
+
+inline void writeF32(std::vector<uint8_t>& out, float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    writeU32(out, bits);
+}
+
+inline void writeVec3(std::vector<uint8_t>& out, const Vec3& v) {
+    writeF32(out, v.x);
+    writeF32(out, v.y);
+    writeF32(out, v.z);
+}
+
+inline Material readMaterial(const uint8_t* p) {
+    Material m;
+    m.color = readVec3(p);
+    m.ambient = readF32(p + 12);
+    m.diffuse = readF32(p + 16);
+    m.specularIntensity = readF32(p + 20);
+    m.shininess = readF32(p + 24);
+    m.reflectivity = readF32(p + 28);
+    m.transparency = readF32(p + 32);
+    m.refractiveIndex = readF32(p + 36);
+    return m;
+}
+
+inline void writeMaterial(std::vector<uint8_t>& out, const Material& m) {
+    writeVec3(out, m.color);
+    writeF32(out, m.ambient);
+    writeF32(out, m.diffuse);
+    writeF32(out, m.specularIntensity);
+    writeF32(out, m.shininess);
+    writeF32(out, m.reflectivity);
+    writeF32(out, m.transparency);
+    writeF32(out, m.refractiveIndex);
+}
+
+inline bool fail(std::string* error, const char* message) {
+    if (error) *error = message;
+    return false;
+}
+
+// Keep file spot cones in the setters' range and refresh their cached cosines
+inline void clampSpot(Light& l) {
+    l.spotAngle = std::fmax(1.0f, std::fmin(90.0f, l.spotAngle));
+    l.spotSoftness = std::fmax(0.0f, std::fmin(1.0f, l.spotSoftness));
+    l.update();
+}
+
+// Reset the parts of the scene a file replaces
+inline void beginLoad(Scene& scene) {
+    scene.spheres.clear();
+    scene.boxes.clear();
+    scene.cylinders.clear();
+    scene.clearMeshes();
+    scene.clearMaterials();
+    scene.currentPreset = ScenePreset::CUSTOM;
+    ++scene.geometryRevision;
+    ++scene.lightRevision;
+}
+
+// ----------------------------------------------------------------------------
+// Binary loader
+// ----------------------------------------------------------------------------
+
+inline bool loadBinary(Scene& scene, const uint8_t* data, size_t size, std::string* error = nullptr) {
+    if (size < kHeaderSize || std::memcmp(data, kMagic, 4) != 0) {
+        return fail(error, "Not a binary scene file");
+    }
+    uint32_t version = readU32(data + 4);
+    if (version < 1 || version > kVersion) {
+        return fail(error, "Unsupported scene file version");
+    }
+    size_t boxSize = version >= 2 ? kBoxSize : kBoxSizeV1;
+    size_t cylinderSize = version >= 2 ? kCylinderSize : kCylinderSizeV1;
+    size_t lightSize = version >= 4 ? kLightSize : version >= 3 ? kLightSizeV3 : kLightSizeV2;
+
+    uint32_t flags = readU32(data + 8);
+    uint64_t materialCount = readU32(data + 12);
+    uint64_t sphereCount = readU32(data + 16);
+    uint64_t boxCount = readU32(data + 20);
+    uint64_t cylinderCount = readU32(data + 24);
+    uint64_t lightCount = readU32(data + 28);
+
+    uint64_t expected = kHeaderSize + ((flags & kFlagCamera) ? kCameraSize : 0) +
+                        materialCount * kMaterialSize + sphereCount * kSphereSize +
+                        boxCount * boxSize + cylinderCount * cylinderSize +
+                        lightCount * lightSize;
+    if (size < expected) {
+        return fail(error, "Scene file is truncated");
+    }
+
+    const uint8_t* p = data + kHeaderSize;
+    const uint8_t* camera = (flags & kFlagCamera) ? p : nullptr;
+    if (camera) p += kCameraSize;
+
+    // Check every reference first, so a bad file leaves the scene untouched
+    const uint8_t* q = p + materialCount * kMaterialSize;
+    for (uint64_t i = 0; i < sphereCount; ++i, q += kSphereSize) {
+        if (readU32(q + 16) >= materialCount) return fail(error, "Sphere references a missing material");
+    }
+    for (uint64_t i = 0; i < boxCount; ++i, q += boxSize) {
+        if (readU32(q + 24) >= materialCount) return fail(error, "Box references a missing material");
+    }
+    for (uint64_t i = 0; i < cylinderCount; ++i, q += cylinderSize) {
+        if (readU32(q + 20) >= materialCount) return fail(error, "Cylinder references a missing material");
+    }
+    for (uint64_t i = 0; version >= 4 && i < lightCount; ++i, q += lightSize) {
+        if (readU32(q + 36) > static_cast<uint32_t>(LightType::SPOT)) return fail(error, "Unknown light type");
+    }
+
+    if (camera) {
+        scene.camera.position = readVec3(camera);
+        scene.camera.target = readVec3(camera + 12);
+        scene.camera.setFov(readF32(camera + 24));
+    }
+
+    beginLoad(scene);
+
+    // File material index -> interned scene material ID
+    std::vector<int> materialIds;
+    materialIds.reserve(materialCount);
+    for (uint64_t i = 0; i < materialCount; ++i, p += kMaterialSize) {
+        materialIds.push_back(scene.addMaterial(readMaterial(p)));
+    }
+
+    scene.spheres.reserve(sphereCount);
+    scene.boxes.reserve(boxCount);
+    scene.cylinders.reserve(cylinderCount);
+
+    for (uint64_t i = 0; i < sphereCount; ++i, p += kSphereSize) {
+        uint32_t mat = readU32(p + 16);
+        scene.spheres.emplace_back(readVec3(p), readF32(p + 12), materialIds[mat]);
+    }
+
+    for (uint64_t i = 0; i < boxCount; ++i, p += boxSize) {
+        uint32_t mat = readU32(p + 24);
+        scene.boxes.emplace_back(readVec3(p), readVec3(p + 12), materialIds[mat]);
+        if (version >= 2) scene.boxes.back().setRotation(readVec3(p + 28));
+    }
+
+    for (uint64_t i = 0; i < cylinderCount; ++i, p += cylinderSize) {
+        uint32_t mat = readU32(p + 20);
+        scene.cylinders.emplace_back(readVec3(p), readF32(p + 12), readF32(p + 16),
+                                     materialIds[mat], readU32(p + 24) != 0);
+        if (version >= 2) scene.cylinders.back().setRotation(readVec3(p + 28));
+    }
+
+    if (lightCount > 0) {
+        scene.lights.clear();
+        scene.lights.reserve(lightCount);
+        for (uint64_t i = 0; i < lightCount; ++i, p += lightSize) {
+            scene.lights.emplace_back(readVec3(p), readVec3(p + 12), readF32(p + 24), readF32(p + 28));
+            Light& l = scene.lights.back();
+            if (version >= 3) l.range = readF32(p + 32);
+            if (version >= 4) {
+                l.type = static_cast<LightType>(readU32(p + 36));
+                Vec3 dir = readVec3(p + 40);
+                if (dir.lengthSquared() > 0.0f) l.direction = dir.normalize();
+                l.spotAngle = readF32(p + 52);
+                l.spotSoftness = readF32(p + 56);
+                clampSpot(l);
+            }
+        }
+    }
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Binary writer
+// ----------------------------------------------------------------------------
+
+inline std::vector<uint8_t> saveBinary(const Scene& scene) {
+    // The scene's material table is already deduplicated, so it is written as-is
+    const std::vector<Material>& materials = scene.materials;
+
+    std::vector<uint8_t> out;
+    out.reserve(kHeaderSize + kCameraSize + materials.size() * kMaterialSize +
+                scene.spheres.size() * kSphereSize + scene.boxes.size() * kBoxSize +
+                scene.cylinders.size() * kCylinderSize + scene.lights.size() * kLightSize);
+
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(kMagic[i]));
+    writeU32(out, kVersion);
+    writeU32(out, kFlagCamera);
+    writeU32(out, static_cast<uint32_t>(materials.size()));
+    writeU32(out, static_cast<uint32_t>(scene.spheres.size()));
+    writeU32(out, static_cast<uint32_t>(scene.boxes.size()));
+    writeU32(out, static_cast<uint32_t>(scene.cylinders.size()));
+    writeU32(out, static_cast<uint32_t>(scene.lights.size()));
+
+    writeVec3(out, scene.camera.position);
+    writeVec3(out, scene.camera.target);
+    writeF32(out, scene.camera.fov);
+
+    for (const auto& m : materials) writeMaterial(out, m);
+
+    for (size_t i = 0; i < scene.spheres.size(); ++i) {
+        writeVec3(out, scene.spheres[i].center);
+        writeF32(out, scene.spheres[i].radius);
+        writeU32(out, static_cast<uint32_t>(scene.spheres[i].materialId));
+    }
+
+    for (size_t i = 0; i < scene.boxes.size(); ++i) {
+        writeVec3(out, scene.boxes[i].center);
+        writeVec3(out, scene.boxes[i].halfSize * 2.0f);
+        writeU32(out, static_cast<uint32_t>(scene.boxes[i].materialId));
+        writeVec3(out, scene.boxes[i].rotation);
+    }
+
+    for (size_t i = 0; i < scene.cylinders.size(); ++i) {
+        const Cylinder& c = scene.cylinders[i];
+        writeVec3(out, c.center);
+        writeF32(out, c.radius);
+        writeF32(out, c.height);
+        writeU32(out, static_cast<uint32_t>(c.materialId));
+        writeU32(out, c.capped ? 1u : 0u);
+        writeVec3(out, c.rotation);
+    }
+
+    for (const auto& l : scene.lights) {
+        writeVec3(out, l.position);
+        writeVec3(out, l.color);
+        writeF32(out, l.intensity);
+        writeF32(out, l.radius);
+        writeF32(out, l.range);
+        writeU32(out, static_cast<uint32_t>(l.type));
+        writeVec3(out, l.direction);
+        writeF32(out, l.spotAngle);
+        writeF32(out, l.spotSoftness);
+    }
+
+    return out;
+}
+
+// ----------------------------------------------------------------------------
+// JSON loader
+// ----------------------------------------------------------------------------
+
+// Minimal pull parser over a byte range; no DOM is built
+class JsonReader {
+public:
+    JsonReader(const char* begin, const char* end) : p(begin), end(end), ok(true) {}
+
+    bool good() const { return ok; }
+    const std::string& message() const { return errorMessage; }
+
+    bool setError(const char* msg) {
+        if (ok) {
+            ok = false;
+            errorMessage = msg;
+        }
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) ++p;
+    }
+
+    bool peek(char c) {
+        skipWhitespace();
+        return p < end && *p == c;
+    }
+
+    bool expect(char c) {
+        skipWhitespace();
+        if (p < end && *p == c) {
+            ++p;
+            return true;
+        }
+        return setError("Unexpected character in JSON");
+    }
+
+    // Object iteration: call beginObject(), then nextKey() until it returns false
+    // Separators are consumed leniently so no per-level state is needed
+    bool beginObject() { return expect('{'); }
+    bool beginArray() { return expect('['); }
+
+    bool nextKey(std::string& key) {
+        if (!ok) return false;
+        if (peek(',')) ++p;
+        if (peek('}')) { ++p; return false; }
+        return readString(key) && expect(':');
+    }
+
+    bool nextElement() {
+        if (!ok) return false;
+        if (peek(',')) ++p;
+        if (peek(']')) { ++p; return false; }
+        if (p >= end) return setError("Unexpected end of JSON");
+        return true;
+    }
+
+    bool readString(std::string& out) {
+        if (!expect('"')) return false;
+        out.clear();
+        while (p < end && *p != '"') {
+            if (*p == '\\' && p + 1 < end) ++p;
+            out.push_back(*p++);
+        }
+        if (p >= end) return setError("Unterminated JSON string");
+        ++p;
+        return true;
+    }
+
+    bool readNumber(float& out) {
+        skipWhitespace();
+        if (!TextParse::parseFloat(p, end, out)) return setError("Expected a JSON number");
+        return true;
+    }
+
+    bool readBool(bool& out) {
+        skipWhitespace();
+        if (end - p >= 4 && std::strncmp(p, "true", 4) == 0) { p += 4; out = true; return true; }
+        if (end - p >= 5 && std::strncmp(p, "false", 5) == 0) { p += 5; out = false; return true; }
+        return setError("Expected a JSON boolean");
+    }
+
+    bool readVec3(Vec3& out) {
+        return expect('[') && readNumber(out.x) && expect(',') && readNumber(out.y) &&
+               expect(',') && readNumber(out.z) && expect(']');
+    }
+
+    // Skip any value (used for unknown keys)
+    bool skipValue() {
+        skipWhitespace();
+        if (p >= end) return setError("Unexpected end of JSON");
+        if (*p == '"') { std::string s; return readString(s); }
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            bool inString = false;
+            for (; p < end; ++p) {
+                char c = *p;
+                if (inString) {
+                    if (c == '\\') ++p;
+                    else if (c == '"') inString = false;
+                } else if (c == '"') {
+                    inString = true;
+                } else if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) { ++p; return true; }
+                }
+            }
+            return setError("Unterminated JSON value");
+        }
+        while (p < end && *p != ',' && *p != '}' && *p != ']') ++p;
+        return true;
+    }
+
+private:
+    const char* p;
+    const char* end;
+    bool ok;
+    std::string errorMessage;
+};
+
+inline bool readJsonMaterial(JsonReader& json, Material& m) {
+    std::string key;
+    if (!json.beginObject()) return false;
+    while (json.nextKey(key)) {
+        if (key == "color") json.readVec3(m.color);
+        else if (key == "ambient") json.readNumber(m.ambient);
+        else if (key == "diffuse") json.readNumber(m.diffuse);
+        else if (key == "specularIntensity") json.readNumber(m.specularIntensity);
+        else if (key == "shininess") json.readNumber(m.shininess);
+        else if (key == "reflectivity") json.readNumber(m.reflectivity);
+        else if (key == "transparency") json.readNumber(m.transparency);
+        else if (key == "refractiveIndex") json.readNumber(m.refractiveIndex);
+        else json.skipValue();
+    }
+    return json.good();
+}
+
+// Primitives first store the file's material index; loadJson remaps them
+// once all materials are known, so sections may appear in any order
+inline bool readJsonMaterialRef(JsonReader& json, int& out) {
+    float index;
+    if (!json.readNumber(index)) return false;
+    // Checked before the cast: out-of-range or NaN floats make it undefined
+    if (!std::isfinite(index) || index < 0.0f || index >= static_cast<float>(INT_MAX)) {
+        return json.setError("Primitive references a missing material");
+    }
+    if (index != std::floor(index)) return json.setError("Material index must be an integer");
+    out = static_cast<int>(index);
+    return true;
+}
+
+// Check every index against the file's materials before any is used
+template <typename Primitive>
+inline bool checkMaterials(const std::vector<Primitive>& primitives, size_t materialCount) {
+    for (const auto& primitive : primitives) {
+        if (primitive.materialId < 0 || static_cast<size_t>(primitive.materialId) >= materialCount) return false;
+    }
+    return true;
+}
+
+template <typename Primitive>
+inline void remapMaterials(std::vector<Primitive>& primitives, const std::vector<int>& materialIds) {
+    for (auto& primitive : primitives) {
+        primitive.materialId = materialIds[primitive.materialId];
+    }
+}
+
+// Everything a JSON file sets, parsed before the scene is touched
+struct JsonScene {
+    Camera camera;
+    bool showGroundPlane = true;
+    std::vector<Material> materials;
+    std::vector<Sphere> spheres;
+    std::vector<Box> boxes;
+    std::vector<Cylinder> cylinders;
+    std::vector<Light> lights;
+    bool lightsSet = false;  // A "lights" section replaces the scene's lights
+};
+
+inline void readJsonScene(JsonReader& json, JsonScene& file) {
+    std::string key, field;
+    if (!json.beginObject()) return;
+    while (json.nextKey(key)) {
+        if (key == "camera") {
+            float fov = file.camera.fov;
+            json.beginObject();
+            while (json.nextKey(field)) {
+                if (field == "position") json.readVec3(file.camera.position);
+                else if (field == "target") json.readVec3(file.camera.target);
+                else if (field == "fov") json.readNumber(fov);
+                else json.skipValue();
+            }
+            file.camera.setFov(fov);
+        } else if (key == "materials") {
+            json.beginArray();
+            while (json.nextElement()) {
+                Material m;
+                readJsonMaterial(json, m);
+                file.materials.push_back(m);
+            }
+        } else if (key == "spheres") {
+            json.beginArray();
+            while (json.nextElement()) {
+                file.spheres.emplace_back();
+                Sphere& s = file.spheres.back();
+                json.beginObject();
+                while (json.nextKey(field)) {
+                    if (field == "center") json.readVec3(s.center);
+                    else if (field == "radius") json.readNumber(s.radius);
+                    else if (field == "material") readJsonMaterialRef(json, s.materialId);
+                    else json.skipValue();
+                }
+                s.update();
+            }
+        } else if (key == "boxes") {
+            json.beginArray();
+            while (json.nextElement()) {
+                file.boxes.emplace_back();
+                Box& b = file.boxes.back();
+                json.beginObject();
+                while (json.nextKey(field)) {
+                    if (field == "center") json.readVec3(b.center);
+                    else if (field == "size") { json.readVec3(b.halfSize); b.halfSize = b.halfSize * 0.5f; }
+                    else if (field == "material") readJsonMaterialRef(json, b.materialId);
+                    else if (field == "rotation") { Vec3 r; json.readVec3(r); b.setRotation(r); }
+                    else json.skipValue();
+                }
+                b.update();
+            }
+        } else if (key == "cylinders") {
+            json.beginArray();
+            while (json.nextElement()) {
+                file.cylinders.emplace_back();
+                Cylinder& c = file.cylinders.back();
+                json.beginObject();
+                while (json.nextKey(field)) {
+                    if (field == "center") json.readVec3(c.center);
+                    else if (field == "radius") json.readNumber(c.radius);
+                    else if (field == "height") json.readNumber(c.height);
+                    else if (field == "capped") json.readBool(c.capped);
+                    else if (field == "material") readJsonMaterialRef(json, c.materialId);
+                    else if (field == "rotation") { Vec3 r; json.readVec3(r); c.setRotation(r); }
+                    else if (field == "axis") { Vec3 a; json.readVec3(a); c.setAxis(a); }
+                    else json.skipValue();
+                }
+                c.update();
+            }
+        } else if (key == "lights") {
+            file.lightsSet = true;
+            json.beginArray();
+            while (json.nextElement()) {
+                file.lights.emplace_back();
+                Light& l = file.lights.back();
+                json.beginObject();
+                while (json.nextKey(field)) {
+                    if (field == "position") json.readVec3(l.position);
+                    else if (field == "color") json.readVec3(l.color);
+                    else if (field == "intensity") json.readNumber(l.intensity);
+                    else if (field == "radius") json.readNumber(l.radius);
+                    else if (field == "range") json.readNumber(l.range);
+                    else if (field == "type") {
+                        std::string type;
+                        json.readString(type);
+                        if (type == "point") l.type = LightType::POINT;
+                        else if (type == "directional") l.type = LightType::DIRECTIONAL;
+                        else if (type == "spot") l.type = LightType::SPOT;
+                        else json.setError("Unknown light type");
+                    }
+                    else if (field == "direction") {
+                        Vec3 dir;
+                        json.readVec3(dir);
+                        if (dir.lengthSquared() > 0.0f) l.direction = dir.normalize();
+                    }
+                    else if (field == "angle") json.readNumber(l.spotAngle);
+                    else if (field == "softness") json.readNumber(l.spotSoftness);
+                    else json.skipValue();
+                }
+                clampSpot(l);
+            }
+        } else if (key == "groundPlane") {
+            json.readBool(file.showGroundPlane);
+        } else {
+            json.skipValue();
+        }
+    }
+}
+
+inline bool loadJson(Scene& scene, const char* data, size_t size, std::string* error = nullptr) {
+    JsonReader json(data, data + size);
+    JsonScene file;
+    file.camera = scene.camera;
+    file.showGroundPlane = scene.showGroundPlane;
+    readJsonScene(json, file);
+
+    if (!json.good()) {
+        return fail(error, json.message().c_str());
+    }
+
+    // Primitives without materials fall back to the default material
+    if (file.materials.empty()) {
+        file.materials.push_back(Material());
+    }
+
+    if (!checkMaterials(file.spheres, file.materials.size()) ||
+        !checkMaterials(file.boxes, file.materials.size()) ||
+        !checkMaterials(file.cylinders, file.materials.size())) {
+        return fail(error, "Primitive references a missing material");
+    }
+
+    // Valid: replace the scene's content
+    beginLoad(scene);
+    scene.camera = file.camera;
+    scene.showGroundPlane = file.showGroundPlane;
+
+    // File material index -> interned scene material ID
+    std::vector<int> materialIds;
+    materialIds.reserve(file.materials.size());
+    for (const Material& m : file.materials) {
+        materialIds.push_back(scene.addMaterial(m));
+    }
+    remapMaterials(file.spheres, materialIds);
+    remapMaterials(file.boxes, materialIds);
+    remapMaterials(file.cylinders, materialIds);
+    scene.spheres = std::move(file.spheres);
+    scene.boxes = std::move(file.boxes);
+    scene.cylinders = std::move(file.cylinders);
+
+    if (file.lightsSet) {
+        scene.lights = std::move(file.lights);
+    }
+    // The scene must always keep at least one light
+    if (scene.lights.empty()) {
+        scene.resetLights();
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Entry points
+// ----------------------------------------------------------------------------
+
+// Load from memory, detecting the format from the magic bytes
+inline bool load(Scene& scene, const uint8_t* data, size_t size, std::string* error = nullptr) {
+    if (size >= 4 && std::memcmp(data, kMagic, 4) == 0) {
+        return loadBinary(scene, data, size, error);
+    }
+    return loadJson(scene, reinterpret_cast<const char*>(data), size, error);
+}
+
+// Load from disk (native builds); files are memory-mapped where supported
+inline bool loadFile(Scene& scene, const char* path, std::string* error = nullptr) {
+    MappedFile file;
+    if (!file.open(path)) return fail(error, "Could not read scene file");
+    return load(scene, file.data(), file.size(), error);
+}
+
+inline bool saveFile(const Scene& scene, const char* path) {
+    std::vector<uint8_t> data = saveBinary(scene);
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace SceneFile
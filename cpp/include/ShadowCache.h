@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Sphere.h"  // For ObjectType
+#include <vector>
+#include <cstdint>
+
+// Primitive that last blocked a shadow ray toward a light
+struct OccluderHint {
+    ObjectType type;
+    int index;
+    uint32_t triangle;  // Mesh instances: the blocking triangle
+
+    OccluderHint() : type(ObjectType::NONE), index(-1), triangle(0) {}
+    OccluderHint(ObjectType t, int i, uint32_t tri = 0) : type(t), index(i), triangle(tri) {}
+};
+
+// Shadow ray counters
+struct ShadowStats {
+    uint64_t queries;    // Shadow rays that consulted the cache
+    uint64_t occluded;   // ... that turned out blocked
+    uint64_t hintHits;   // ... that the cached occluder alone resolved
+
+    ShadowStats() : queries(0), occluded(0), hintHits(0) {}
+
+    void reset() {
+        queries = 0;
+        occluded = 0;
+        hintHits = 0;
+    }
+
+    void add(const ShadowStats& other) {
+        queries += other.queries;
+        occluded += other.occluded;
+        hintHits += other.hintHits;
+    }
+
+    // Share of blocked shadow rays found by the first (cached) test
+    float hitRate() const {
+        return occluded > 0 ? static_cast<float>(hintHits) / occluded : 0.0f;
+    }
+};
+
+// Per-thread last-occluder cache for shadow rays
+// Neighbouring shading points usually have the same blocker toward a light,
+// so testing it first often settles the query with a single intersection.
+// Entries are only hints: a stale one costs one wasted test, never a wrong answer.
+struct ShadowCache {
+    std::vector<OccluderHint> lastOccluder;  // Indexed by light
+    ShadowStats stats;                       // This thread's rays since the last take
+
+    OccluderHint& slot(int light) {
+        if (light >= static_cast<int>(lastOccluder.size())) {
+            lastOccluder.resize(light + 1);
+        }
+        return lastOccluder[light];
+    }
+};
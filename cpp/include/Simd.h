@@ -0,0 +1,96 @@
+#pragma once
+
+// ============================================================================
+// 4-wide float backend for Vec3, chosen at build time
+// ============================================================================
+//
+// SSE on x86-64, SIMD128 on WebAssembly (emcc -msimd128), NEON on AArch64.
+// Define RT_NO_SIMD to force the scalar Vec3. Only the handful of lane-wise
+// operations Vec3 needs are wrapped; the fourth lane is always kept at 0.
+
+#if !defined(RT_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64)
+#define RT_SIMD_SSE 1
+#elif defined(__wasm_simd128__)
+#define RT_SIMD_WASM 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define RT_SIMD_NEON 1
+#endif
+#endif
+
+#if defined(RT_SIMD_SSE) || defined(RT_SIMD_WASM) || defined(RT_SIMD_NEON)
+#define RT_SIMD 1
+#endif
+
+#if defined(RT_SIMD_SSE)
+#include <emmintrin.h>
+#elif defined(RT_SIMD_WASM)
+#include <wasm_simd128.h>
+#elif defined(RT_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(RT_SIMD)
+namespace simd {
+
+#if defined(RT_SIMD_SSE)
+
+typedef __m128 f32x4;
+
+inline f32x4 make(float x, float y, float z) { return _mm_set_ps(0.0f, z, y, x); }
+inline f32x4 splat(float s) { return _mm_set1_ps(s); }
+inline f32x4 add(f32x4 a, f32x4 b) { return _mm_add_ps(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return _mm_sub_ps(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return _mm_mul_ps(a, b); }
+inline f32x4 div(f32x4 a, f32x4 b) { return _mm_div_ps(a, b); }
+// (y, z, x, w)
+inline f32x4 rotate(f32x4 a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)); }
+// max(0, min(1, a)); NaN lanes become 1 like fmax(0, fmin(1, NaN))
+inline f32x4 saturate(f32x4 a) {
+    return _mm_max_ps(_mm_min_ps(a, _mm_set1_ps(1.0f)), _mm_setzero_ps());
+}
+
+#elif defined(RT_SIMD_WASM)
+
+typedef v128_t f32x4;
+
+inline f32x4 make(float x, float y, float z) { return wasm_f32x4_make(x, y, z, 0.0f); }
+inline f32x4 splat(float s) { return wasm_f32x4_splat(s); }
+inline f32x4 add(f32x4 a, f32x4 b) { return wasm_f32x4_add(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return wasm_f32x4_sub(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return wasm_f32x4_mul(a, b); }
+inline f32x4 div(f32x4 a, f32x4 b) { return wasm_f32x4_div(a, b); }
+inline f32x4 rotate(f32x4 a) { return wasm_i32x4_shuffle(a, a, 1, 2, 0, 3); }
+// Pseudo-min/max pick the second operand unless the first compares smaller/larger
+inline f32x4 saturate(f32x4 a) {
+    return wasm_f32x4_pmax(wasm_f32x4_splat(0.0f), wasm_f32x4_pmin(wasm_f32x4_splat(1.0f), a));
+}
+
+#elif defined(RT_SIMD_NEON)
+
+typedef float32x4_t f32x4;
+
+inline f32x4 make(float x, float y, float z) {
+    float lanes[4] = {x, y, z, 0.0f};
+    return vld1q_f32(lanes);
+}
+inline f32x4 splat(float s) { return vdupq_n_f32(s); }
+inline f32x4 add(f32x4 a, f32x4 b) { return vaddq_f32(a, b); }
+inline f32x4 sub(f32x4 a, f32x4 b) { return vsubq_f32(a, b); }
+inline f32x4 mul(f32x4 a, f32x4 b) { return vmulq_f32(a, b); }
+inline f32x4 div(f32x4 a, f32x4 b) { return vdivq_f32(a, b); }
+inline f32x4 rotate(f32x4 a) {
+    // (x y z w) -> (y z w x), then put w back in the last lane
+    f32x4 r = vextq_f32(a, a, 1);
+    r = vsetq_lane_f32(vgetq_lane_f32(a, 0), r, 2);
+    return vsetq_lane_f32(vgetq_lane_f32(a, 3), r, 3);
+}
+// The "nm" variants return the number when one operand is NaN
+inline f32x4 saturate(f32x4 a) {
+    return vmaxnmq_f32(vminnmq_f32(a, vdupq_n_f32(1.0f)), vdupq_n_f32(0.0f));
+}
+
+#endif
+
+}  // namespace simd
+#endif
@@ -4,42 +4,66 @@
 #include "Ray.h"
 #include "Material.h"
 
+// Primitive kinds, used to identify what a ray hit
+enum class ObjectType {
+    NONE = 0,
+    SPHERE = 1,
+    BOX = 2,
+    CYLINDER = 3,
+    PLANE = 4,
+    MESH = 5
+};
+
 struct HitRecord {
     float t;
     Vec3 point;
     Vec3 normal;
-    Material material;
+    Material material;      // Resolved from materialId by Scene::trace
     bool hit;
+    ObjectType objectType;  // Filled in by Scene::trace
+    int objectIndex;        // Index into the matching Scene vector
+    int materialId;         // Index into Scene::materials
 
-    HitRecord() : t(-1), hit(false) {}
+    HitRecord() : t(-1), hit(false), objectType(ObjectType::NONE), objectIndex(-1), materialId(-1) {}
 };
 
 struct Sphere {
     Vec3 center;
     float radius;
-    Material material;
+    int materialId;    // Index into Scene::materials
+
+    // Intersection-ready data; call update() after changing center/radius
+    float radius2;
+    float invRadius;
 
-    Sphere() : center(), radius(1.0f), material() {}
+    Sphere() : center(), radius(1.0f), materialId(0) { update(); }
     
-    Sphere(const Vec3& c, float r, const Material& mat) 
-        : center(c), radius(r), material(mat) {}
+    Sphere(const Vec3& c, float r, int mat) 
+        : center(c), radius(r), materialId(mat) { update(); }
 
+    void update() {
+        radius2 = radius * radius;
+        invRadius = 1.0f / radius;
+    }
+
+    // Rays are unit length (Ray normalizes), so the quadratic's a = 1 and
+    // with the half-b form t = -b' -+ sqrt(b'^2 - c): no division at all
     HitRecord intersect(const Ray& ray) const {
         HitRecord record;
         
         Vec3 oc = ray.origin - center;
-        float a = ray.direction.dot(ray.direction);
-        float b = 2.0f * oc.dot(ray.direction);
-        float c = oc.dot(oc) - radius * radius;
-        float discriminant = b * b - 4 * a * c;
+        float b = oc.dot(ray.direction);
+        float c = oc.dot(oc) - radius2;
+        float discriminant = b * b - c;
 
         if (discriminant < 0) {
             return record;
         }
 
-        float t = (-b - std::sqrt(discriminant)) / (2.0f * a);
+        float sqrtD = std::sqrt(discriminant);
+        float t = -b - sqrtD;
         if (t <= 0.001f) {
-            t = (-b + std::sqrt(discriminant)) / (2.0f * a);
+            t = -b + sqrtD;
             if (t <= 0.001f) {
                 return record;
             }
@@ -47,11 +71,10 @@ struct Sphere {
 
         record.t = t;
         record.point = ray.at(t);
-        record.normal = (record.point - center).normalize();
-        record.material = material;
+        record.normal = (record.point - center) * invRadius;
+        record.materialId = materialId;
         record.hit = true;
 
         return record;
     }
 };
-
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+// Locale-independent number parsing over [p, end) byte ranges
+// (mapped files are not NUL-terminated, so strtof can't be used)
+namespace TextParse {
+
+// Parse a decimal float with optional sign, fraction and exponent
+// Advances p past the number; returns false (p unchanged) unless the
+// mantissa has at least one digit, so "-", "." and "-." are rejected.
+// An "e" without exponent digits is left unread, as strtof does.
+inline bool parseFloat(const char*& p, const char* end, float& out) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    double value = 0.0;
+    bool digits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10.0 + (*p++ - '0');
+        digits = true;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        double scale = 0.1;
+        while (p < end && *p >= '0' && *p <= '9') {
+            value += (*p++ - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+    if (!digits) {
+        p = start;
+        return false;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* mark = p++;
+        bool negExp = false;
+        if (p < end && (*p == '-' || *p == '+')) negExp = (*p++ == '-');
+        if (p < end && *p >= '0' && *p <= '9') {
+            int exponent = 0;
+            while (p < end && *p >= '0' && *p <= '9') {
+                // Anything past 64 already over/underflows a float
+                if (exponent < 1000) exponent = exponent * 10 + (*p - '0');
+                ++p;
+            }
+            double factor = 1.0;
+            for (int i = 0; i < exponent && i < 64; ++i) factor *= 10.0;
+            value = negExp ? value / factor : value * factor;
+        } else {
+            p = mark;
+        }
+    }
+
+    out = static_cast<float>(negative ? -value : value);
+    return true;
+}
+
+// Parse a signed decimal integer
+// Returns false (p unchanged) without digits or if it does not fit in int64
+inline bool parseInt(const char*& p, const char* end, int64_t& out) {
+    const char* start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+    const int64_t limit = std::numeric_limits<int64_t>::max();
+    int64_t value = 0;
+    const char* digits = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        int digit = *p++ - '0';
+        if (value > (limit - digit) / 10) {
+            p = start;
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+
+    if (p == digits) {
+        p = start;
+        return false;
+    }
+    out = negative ? -value : value;
+    return true;
+}
+
+} // namespace TextParse
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WebAssembly only has threads when built with -pthread (SharedArrayBuffer);
+// without them every frame runs on the calling thread
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define RT_THREADS 1
+#endif
+
+// ============================================================================
+// Parallel tile scheduler
+// ============================================================================
+//
+// Runs a job over a list of tiles on a persistent pool of worker threads; the
+// calling thread is worker 0. The list arrives ordered most expensive first
+// and is dealt round-robin into one queue per worker, so every worker starts
+// on the costliest tiles it owns. A worker that empties its queue steals from
+// the back (the cheapest end) of the others until no tile is left.
+//
+// Each queue is a slice of one shared array plus a packed (head, tail) word;
+// the owner pops the head and thieves pop the tail, both with one CAS. No
+// tiles are added during a run, so an empty scan means the run is done.
+
+class TileScheduler {
+public:
+    static constexpr int kMaxThreads = 256;
+
+    TileScheduler()
+        : threadCount(1)
+        , generation(0)
+        , pending(0)
+        , shuttingDown(false)
+        , job(nullptr)
+        , context(nullptr) {
+        queues.reset(new WorkerQueue[1]);
+    }
+
+    ~TileScheduler() {
+        stopWorkers();
+    }
+
+    TileScheduler(const TileScheduler&) = delete;
+    TileScheduler& operator=(const TileScheduler&) = delete;
+
+    static int hardwareThreads() {
+#if defined(RT_THREADS)
+        unsigned int count = std::thread::hardware_concurrency();
+        return count > 0 ? static_cast<int>(count) : 1;
+#else
+        return 1;
+#endif
+    }
+
+    // Worker count including the calling thread; 0 = one per hardware thread
+    // Not thread-safe: call between frames
+    void setThreadCount(int count) {
+        if (count <= 0) {
+            count = hardwareThreads();
+        }
+#if !defined(RT_THREADS)
+        count = 1;
+#endif
+        count = count < kMaxThreads ? count : kMaxThreads;
+        if (count == threadCount) {
+            return;
+        }
+        stopWorkers();
+        threadCount = count;
+        queues.reset(new WorkerQueue[count]);
+    }
+
+    int getThreadCount() const {
+        return threadCount;
+    }
+
+    // Call fn(tile, worker) once for each of the count tiles in `order`
+    // (most expensive first) and return when all are done
+    template <typename Fn>
+    void run(const uint32_t* order, int count, Fn& fn) {
+        deal(order, count);
+        job = &invoke<Fn>;
+        context = &fn;
+
+        if (threadCount == 1) {
+            work(0);
+            return;
+        }
+
+        startWorkers();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending = threadCount - 1;
+            ++generation;
+        }
+        startSignal.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneSignal.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    // Owner pops the head, thieves the tail; both live in one word so a
+    // single CAS settles a race for the last tile
+    struct alignas(64) WorkerQueue {
+        std::atomic<uint64_t> range;  // head | tail << 32, indices into `tiles`
+
+        WorkerQueue() : range(0) {}
+    };
+
+    using Job = void (*)(void* context, int tile, int worker);
+
+    int threadCount;
+    std::vector<uint32_t> tiles;  // Queue slices, worker by worker
+    std::unique_ptr<WorkerQueue[]> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startSignal;
+    std::condition_variable doneSignal;
+    uint64_t generation;  // Bumped to start a run
+    int pending;          // Pool threads still working on the current run
+    bool shuttingDown;
+
+    Job job;
+    void* context;
+
+    template <typename Fn>
+    static void invoke(void* context, int tile, int worker) {
+        (*static_cast<Fn*>(context))(tile, worker);
+    }
+
+    static uint64_t pack(uint32_t head, uint32_t tail) {
+        return head | (static_cast<uint64_t>(tail) << 32);
+    }
+
+    // Round-robin deal: worker w gets order[w], order[w + n], ... in that order
+    void deal(const uint32_t* order, int count) {
+        if (tiles.size() < static_cast<size_t>(count)) {
+            tiles.resize(count);
+        }
+        uint32_t offset = 0;
+        for (int w = 0; w < threadCount; ++w) {
+            uint32_t head = offset;
+            for (int i = w; i < count; i += threadCount) {
+                tiles[offset++] = order[i];
+            }
+            queues[w].range.store(pack(head, offset), std::memory_order_relaxed);
+        }
+    }
+
+    int popHead(int worker) {
+        std::atomic<uint64_t>& range = queues[worker].range;
+        uint64_t r = range.load(std::memory_order_relaxed);
+        for (;;) {
+            uint32_t head = static_cast<uint32_t>(r);
+            uint32_t tail = static_cast<uint32_t>(r >> 32);
+            if (head >= tail) {
+                return -1;
+            }
+            if (range.compare_exchange_weak(r, pack(head + 1, tail), std::memory_order_relaxed)) {
+                return static_cast<int>(tiles[head]);
+            }
+        }
+    }
+
+    int popTail(int worker) {
+        std::atomic<uint64_t>& range = queues[worker].range;
+        uint64_t r = range.load(std::memory_order_relaxed);
+        for (;;) {
+            uint32_t head = static_cast<uint32_t>(r);
+            uint32_t tail = static_cast<uint32_t>(r >> 32);
+            if (head >= tail) {
+                return -1;
+            }
+            if (range.compare_exchange_weak(r, pack(head, tail - 1), std::memory_order_relaxed)) {
+                return static_cast<int>(tiles[tail - 1]);
+            }
+        }
+    }
+
+    void work(int worker) {
+        for (;;) {
+            int tile = popHead(worker);
+            for (int i = 1; tile < 0 && i < threadCount; ++i) {
+                tile = popTail((worker + i) % threadCount);
+            }
+            if (tile < 0) {
+                return;
+            }
+            job(context, tile, worker);
+        }
+    }
+
+    void startWorkers() {
+#if defined(RT_THREADS)
+        if (!workers.empty()) {
+            return;
+        }
+        shuttingDown = false;
+        workers.reserve(threadCount - 1);
+        for (int w = 1; w < threadCount; ++w) {
+            workers.emplace_back(&TileScheduler::workerMain, this, w, generation);
+        }
+#endif
+    }
+
+    void stopWorkers() {
+        if (workers.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shuttingDown = true;
+        }
+        startSignal.notify_all();
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    void workerMain(int worker, uint64_t seen) {
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startSignal.wait(lock, [&] { return shuttingDown || generation != seen; });
+                if (shuttingDown) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            work(worker);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--pending == 0) {
+                doneSignal.notify_one();
+            }
+        }
+    }
+};
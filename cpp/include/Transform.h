@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Vec3.h"
+#include <cmath>
+
+// Affine transform stored as the top three rows of a 4x4 matrix
+// (linear 3x3 part in columns 0-2, translation in column 3)
+struct Transform {
+    float m[3][4];
+
+    Transform() {
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) m[r][c] = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+
+    static Transform translate(const Vec3& t) {
+        Transform x;
+        x.m[0][3] = t.x;
+        x.m[1][3] = t.y;
+        x.m[2][3] = t.z;
+        return x;
+    }
+
+    static Transform scale(const Vec3& s) {
+        Transform x;
+        x.m[0][0] = s.x;
+        x.m[1][1] = s.y;
+        x.m[2][2] = s.z;
+        return x;
+    }
+
+    // Rotation about a principal axis (0 = X, 1 = Y, 2 = Z), in degrees
+    static Transform rotate(int axis, float degrees) {
+        float rad = degrees * 3.14159265358979f / 180.0f;
+        float c = std::cos(rad);
+        float s = std::sin(rad);
+        int a = (axis + 1) % 3;
+        int b = (axis + 2) % 3;
+        Transform x;
+        x.m[a][a] = c;
+        x.m[a][b] = -s;
+        x.m[b][a] = s;
+        x.m[b][b] = c;
+        return x;
+    }
+
+    // Scale, then rotate about Z, X and Y (degrees), then translate
+    static Transform fromTRS(const Vec3& translation, const Vec3& rotation, const Vec3& scaling) {
+        return translate(translation) * rotate(1, rotation.y) * rotate(0, rotation.x) *
+               rotate(2, rotation.z) * scale(scaling);
+    }
+
+    Transform operator*(const Transform& o) const {
+        Transform x;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                x.m[r][c] = m[r][0] * o.m[0][c] + m[r][1] * o.m[1][c] + m[r][2] * o.m[2][c] +
+                            (c == 3 ? m[r][3] : 0.0f);
+            }
+        }
+        return x;
+    }
+
+    Vec3 point(const Vec3& p) const {
+        return Vec3(
+            m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+            m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+            m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]
+        );
+    }
+
+    Vec3 vector(const Vec3& v) const {
+        return Vec3(
+            m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+            m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+            m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z
+        );
+    }
+
+    // Multiply by the transposed linear part
+    // Called on the inverse transform, this maps normals to the other space
+    Vec3 transposedVector(const Vec3& v) const {
+        return Vec3(
+            m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z,
+            m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z,
+            m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z
+        );
+    }
+
+    // General affine inverse (returns identity for a singular matrix)
+    Transform inverse() const {
+        float a = m[0][0], b = m[0][1], c = m[0][2];
+        float d = m[1][0], e = m[1][1], f = m[1][2];
+        float g = m[2][0], h = m[2][1], i = m[2][2];
+
+        float c00 = e * i - f * h;
+        float c01 = c * h - b * i;
+        float c02 = b * f - c * e;
+        float det = a * c00 + d * c01 + g * c02;
+        if (std::abs(det) < 1e-12f) {
+            return Transform();
+        }
+        float invDet = 1.0f / det;
+
+        Transform x;
+        x.m[0][0] = c00 * invDet;
+        x.m[0][1] = c01 * invDet;
+        x.m[0][2] = c02 * invDet;
+        x.m[1][0] = (f * g - d * i) * invDet;
+        x.m[1][1] = (a * i - c * g) * invDet;
+        x.m[1][2] = (c * d - a * f) * invDet;
+        x.m[2][0] = (d * h - e * g) * invDet;
+        x.m[2][1] = (b * g - a * h) * invDet;
+        x.m[2][2] = (a * e - b * d) * invDet;
+
+        Vec3 t = x.vector(Vec3(m[0][3], m[1][3], m[2][3]));
+        x.m[0][3] = -t.x;
+        x.m[1][3] = -t.y;
+        x.m[2][3] = -t.z;
+        return x;
+    }
+};
@@ -1,13 +1,63 @@
 #pragma once
 
+#include "Simd.h"
 #include <cmath>
 
+// With a SIMD backend (see Simd.h) the components share a 16-byte register
+// with an unused fourth lane, and the lane-wise operators map to single
+// vector instructions. The interface is the same either way.
+#if defined(RT_SIMD)
+struct alignas(16) Vec3 {
+    union {
+        struct { float x, y, z, w; };
+        simd::f32x4 v;
+    };
+
+    Vec3() : v(simd::splat(0.0f)) {}
+    Vec3(float x, float y, float z) : v(simd::make(x, y, z)) {}
+    explicit Vec3(simd::f32x4 lanes) : v(lanes) {}
+#else
 struct Vec3 {
     float x, y, z;
 
     Vec3() : x(0), y(0), z(0) {}
     Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+#endif
 
+    // Component access by axis index (0 = x, 1 = y, 2 = z)
+    float operator[](int axis) const {
+        return axis == 0 ? x : (axis == 1 ? y : z);
+    }
+
+#if defined(RT_SIMD)
+    Vec3 operator+(const Vec3& o) const {
+        return Vec3(simd::add(v, o.v));
+    }
+
+    Vec3 operator-(const Vec3& o) const {
+        return Vec3(simd::sub(v, o.v));
+    }
+
+    Vec3 operator*(float t) const {
+        return Vec3(simd::mul(v, simd::splat(t)));
+    }
+
+    Vec3 operator*(const Vec3& o) const {
+        return Vec3(simd::mul(v, o.v));
+    }
+
+    // Lane products are summed in x, y, z order, as in the scalar path
+    float dot(const Vec3& o) const {
+        Vec3 p(simd::mul(v, o.v));
+        return p.x + p.y + p.z;
+    }
+
+    // a.yzx * b.zxy - a.zxy * b.yzx, computed as (a * b.yzx - a.yzx * b).yzx
+    Vec3 cross(const Vec3& o) const {
+        simd::f32x4 c = simd::sub(simd::mul(v, simd::rotate(o.v)), simd::mul(simd::rotate(v), o.v));
+        return Vec3(simd::rotate(c));
+    }
+#else
     Vec3 operator+(const Vec3& v) const {
         return Vec3(x + v.x, y + v.y, z + v.z);
     }
@@ -35,19 +85,26 @@ struct Vec3 {
             x * v.y - y * v.x
         );
     }
+#endif
 
     float length() const {
-        return std::sqrt(x * x + y * y + z * z);
+        return std::sqrt(dot(*this));
     }
 
     float lengthSquared() const {
-        return x * x + y * y + z * z;
+        return dot(*this);
     }
 
+    // Divides rather than multiplying by 1 / len: the reciprocal's rounding
+    // shifted grazing reflections, and with SIMD the divide is one instruction
     Vec3 normalize() const {
         float len = length();
         if (len > 0) {
+#if defined(RT_SIMD)
+            return Vec3(simd::div(v, simd::splat(len)));
+#else
             return Vec3(x / len, y / len, z / len);
+#endif
         }
         return Vec3(0, 0, 0);
     }
@@ -58,12 +115,13 @@ struct Vec3 {
     }
 
     // Clamp each component between 0 and 1
+    // (NaN components become 1, matching fmax(0, fmin(1, NaN)))
     Vec3 clamp() const {
-        return Vec3(
-            std::fmax(0.0f, std::fmin(1.0f, x)),
-            std::fmax(0.0f, std::fmin(1.0f, y)),
-            std::fmax(0.0f, std::fmin(1.0f, z))
-        );
+#if defined(RT_SIMD)
+        return Vec3(simd::saturate(v));
+#else
+        return Vec3(saturate(x), saturate(y), saturate(z));
+#endif
     }
 
     // Refract vector through surface using Snell's law
@@ -81,5 +139,13 @@ struct Vec3 {
         float cosT = std::sqrt(1.0f - sin2T);
         return *this * eta + normal * (eta * cosI - cosT);
     }
+
+#if !defined(RT_SIMD)
+private:
+    // Plain compares; fmax/fmin are library calls without -ffast-math
+    static float saturate(float c) {
+        return c < 1.0f ? (c > 0.0f ? c : 0.0f) : 1.0f;
+    }
+#endif
 };
 
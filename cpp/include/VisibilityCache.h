@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Vec3.h"
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+// Sparse voxel cache of light visibility (shadow factors)
+// Entries are keyed on a world-space cell, the light and the dominant axis of
+// the surface normal (so two faces meeting in one cell don't share a value).
+// The first shading point in a cell computes the factor; later ones reuse it,
+// so camera-only changes skip most shadow rays. Shadows are quantized to the
+// cell size, and the whole cache is dropped whenever the geometry, the lights
+// or the shadow settings change.
+//
+// Render threads share the cache: it is split into shards by key hash, each
+// with its own lock, and factors are computed outside the lock. When two
+// threads miss the same cell at once both compute it and the first insert
+// wins, so with several threads which shading point fills a cell can vary.
+class VisibilityCache {
+public:
+    VisibilityCache()
+        : cellSize(0.02f)
+        , invCellSize(50.0f)
+        , geometryRevision(0)
+        , lightRevision(0)
+        , settings(-1) {}
+
+    float getCellSize() const {
+        return cellSize;
+    }
+
+    void setCellSize(float size) {
+        cellSize = size;
+        invCellSize = 1.0f / size;
+        clear();
+    }
+
+    // Drop all entries if anything the shadow factors depend on changed
+    void validate(unsigned int geometryRev, unsigned int lightRev, int shadowSettings) {
+        if (geometryRev != geometryRevision || lightRev != lightRevision || shadowSettings != settings) {
+            clear();
+            geometryRevision = geometryRev;
+            lightRevision = lightRev;
+            settings = shadowSettings;
+        }
+    }
+
+    // Not thread-safe with lookup(): call between frames
+    void clear() {
+        for (Shard& shard : shards) {
+            shard.entries.clear();
+        }
+        settings = -1;
+    }
+
+    size_t size() const {
+        size_t count = 0;
+        for (const Shard& shard : shards) {
+            count += shard.entries.size();
+        }
+        return count;
+    }
+
+    // Lookups answered from the cache / computed, over the cache's lifetime
+    uint64_t hits() const {
+        uint64_t count = 0;
+        for (const Shard& shard : shards) {
+            count += shard.hits;
+        }
+        return count;
+    }
+
+    uint64_t misses() const {
+        uint64_t count = 0;
+        for (const Shard& shard : shards) {
+            count += shard.misses;
+        }
+        return count;
+    }
+
+    // Cached factor for the cell containing p, or compute() on a miss
+    template <typename ComputeFn>
+    float lookup(const Vec3& p, const Vec3& normal, int light, ComputeFn compute) {
+        Key key = makeKey(p, normal, light);
+        size_t hash = KeyHash()(key);
+        Shard& shard = shards[(hash >> 24) & (kShards - 1)];
+        {
+            std::lock_guard<std::mutex> lock(shard.lock);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end()) {
+                ++shard.hits;
+                return it->second;
+            }
+            ++shard.misses;
+        }
+
+        float factor = compute();
+
+        std::lock_guard<std::mutex> lock(shard.lock);
+        if (shard.entries.size() >= kMaxEntries / kShards) {
+            shard.entries.clear();
+        }
+        shard.entries.emplace(key, factor);
+        return factor;
+    }
+
+private:
+    static constexpr size_t kMaxEntries = size_t(1) << 22;
+    static constexpr size_t kShards = 64;
+
+    struct Key {
+        int32_t x, y, z;
+        int32_t lightFace;  // light * 6 + dominant normal axis/sign
+
+        bool operator==(const Key& o) const {
+            return x == o.x && y == o.y && z == o.z && lightFace == o.lightFace;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = static_cast<uint32_t>(k.x) * 0x9E3779B97F4A7C15ull;
+            h ^= static_cast<uint32_t>(k.y) * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+            h ^= static_cast<uint32_t>(k.z) * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+            h ^= static_cast<uint32_t>(k.lightFace) * 0x27D4EB2F165667C5ull + (h << 6) + (h >> 2);
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    struct alignas(64) Shard {
+        std::mutex lock;
+        std::unordered_map<Key, float, KeyHash> entries;
+        uint64_t hits;
+        uint64_t misses;
+
+        Shard() : hits(0), misses(0) {}
+    };
+
+    float cellSize;
+    float invCellSize;
+    unsigned int geometryRevision;
+    unsigned int lightRevision;
+    int settings;
+    Shard shards[kShards];
+
+    Key makeKey(const Vec3& p, const Vec3& n, int light) const {
+        float ax = std::abs(n.x), ay = std::abs(n.y), az = std::abs(n.z);
+        int face = (ax >= ay && ax >= az) ? (n.x < 0.0f ? 1 : 0)
+                 : (ay >= az)             ? (n.y < 0.0f ? 3 : 2)
+                                          : (n.z < 0.0f ? 5 : 4);
+        Key key;
+        key.x = static_cast<int32_t>(std::floor(p.x * invCellSize));
+        key.y = static_cast<int32_t>(std::floor(p.y * invCellSize));
+        key.z = static_cast<int32_t>(std::floor(p.z * invCellSize));
+        key.lightFace = light * 6 + face;
+        return key;
+    }
+};
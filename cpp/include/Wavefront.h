@@ -0,0 +1,345 @@
+#pragma once
+
+#include "Scene.h"
+#include "GBuffer.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+// ============================================================================
+// Wavefront tracer
+// ============================================================================
+//
+// Breadth-first alternative to Scene::traceRay for a batch of camera rays.
+// Depth by depth, every ray of the level is intersected in one loop, then
+// every hit is shaded in another, which queues its reflection / refraction
+// rays as the next level. Optionally a level is sorted by direction octant
+// and origin cell before it is traced, so rays that travel the same way
+// through the same region (and hit the same objects and BVH nodes) run back
+// to back. Bounces are queued in the order of their camera rays, which the
+// tile's pixel order already keeps coherent, so the sort rarely pays off
+// (see the renderer docs).
+//
+// Each level is kept until the end; a final pass from the deepest level up
+// folds child colors into their parents with the same blends (and the same
+// per-level clamp) as shadeHit(), so the result matches the recursive tracer
+// bit for bit when no random sampling is involved.
+
+class Wavefront {
+public:
+    // Start a new batch
+    void begin() {
+        depthCount = 0;
+        levelAt(0).clear();
+        primaryFeatures.clear();
+        primaryWeights.clear();
+    }
+
+    // Queue a camera ray; its G-buffer pixel (-1 for none) gets the primary
+    // hit with `weight`. Returns the sample's index for sampleColor().
+    uint32_t addPrimary(const Ray& ray, int featurePixel, float weight) {
+        std::vector<Node>& primaries = levels[0];
+        Node node;
+        node.ray = ray;
+        node.parent = 0;
+        node.slot = 0;
+        node.kind = PENDING;
+        node.throughput = 1.0f;
+        primaries.push_back(node);
+        primaryFeatures.push_back(featurePixel);
+        primaryWeights.push_back(weight);
+        return static_cast<uint32_t>(primaries.size() - 1);
+    }
+
+    // Trace every queued ray to completion; features (if not null) receives
+    // the primary hits of samples queued with a feature pixel
+    void trace(const Scene& scene, GBuffer* features, bool sortRays) {
+        int maxDepth = scene.maxReflectionDepth;
+        depthCount = 1;
+        // Every level exists up front: resizing `levels` mid-trace would
+        // invalidate references into it
+        levelAt(std::max(maxDepth, 0));
+
+        for (int depth = 0; depth < depthCount; ++depth) {
+            std::vector<Node>& level = levels[depth];
+            if (level.empty()) {
+                break;
+            }
+            // Camera rays are never sorted: they arrive in pixel order
+            sortLevel(depth, sortRays && depth > 0);
+
+            // Intersect
+            if (hits.size() < level.size()) {
+                hits.resize(level.size());
+            }
+            for (uint32_t i : order) {
+                // Past the depth limit a camera ray only sees the background,
+                // unless its features are recorded (see Renderer::traceSample)
+                bool feature = depth == 0 && features && primaryFeatures[i] >= 0;
+                if (depth >= maxDepth && !feature) {
+                    hits[i].hit = false;
+                    continue;
+                }
+                hits[i] = scene.trace(level[i].ray);
+                if (feature && hits[i].hit) {
+                    features->accumulate(primaryFeatures[i], hits[i], primaryWeights[i]);
+                }
+            }
+
+            // Shade, queueing the next level
+            for (uint32_t i : order) {
+                shade(scene, depth, i, hits[i], maxDepth);
+            }
+        }
+
+        // Fold children into parents, deepest level first
+        for (int depth = depthCount - 1; depth > 0; --depth) {
+            std::vector<Node>& parents = levels[depth - 1];
+            for (const Node& node : levels[depth]) {
+                Node& parent = parents[node.parent];
+                (node.slot == 0 ? parent.reflected : parent.refracted) = resolve(node);
+            }
+        }
+        for (Node& node : levels[0]) {
+            node.color = resolve(node);
+        }
+    }
+
+    // Final color of a primary sample after trace()
+    const Vec3& sampleColor(uint32_t index) const {
+        return levels[0][index].color;
+    }
+
+private:
+    enum Kind : uint8_t {
+        PENDING,     // Not shaded yet
+        RESOLVED,    // color is final (background)
+        OPAQUE,      // color is local lighting
+        MIRROR,      // Blend with reflected by weight
+        GLASS,       // Blend reflected / tinted refracted by fresnel, then by weight
+        GLASS_TIR,   // Total internal reflection: blend with reflected by weight
+        PICKED       // Stochastic bounce: Scene::rouletteBlend, roulette scale kept in fresnel
+    };
+
+    struct Node {
+        Ray ray;
+        uint32_t parent;  // Index in the previous level
+        uint8_t slot;     // 0 = parent's reflected, 1 = parent's refracted
+        uint8_t kind;
+        float throughput; // Share of the pixel (stochastic bounces only)
+        Vec3 color;
+        Vec3 tint;
+        float weight;
+        float fresnel;
+        Vec3 reflected;
+        Vec3 refracted;
+    };
+
+    std::vector<std::vector<Node>> levels;
+    std::vector<HitRecord> hits;
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> sortedKeys;
+    std::vector<uint32_t> order;  // Trace order of the current level
+    std::vector<int32_t> primaryFeatures;
+    std::vector<float> primaryWeights;
+    int depthCount = 0;
+
+    std::vector<Node>& levelAt(int depth) {
+        if (static_cast<int>(levels.size()) <= depth) {
+            levels.resize(depth + 1);
+        }
+        return levels[depth];
+    }
+
+    // Mirrors Scene::shadeHit, with bounces queued instead of traced
+    void shade(const Scene& scene, int depth, uint32_t index, const HitRecord& hit, int maxDepth) {
+        Node& node = levels[depth][index];
+        if (!hit.hit) {
+            node.kind = RESOLVED;
+            node.color = scene.getBackgroundColor(node.ray);
+            return;
+        }
+
+        node.color = scene.calculateLocalLighting(node.ray, hit);
+        node.kind = OPAQUE;
+        float transparency = hit.material.transparency;
+        float reflectivity = hit.material.reflectivity;
+        Vec3 viewDir = node.ray.direction;
+
+        if (transparency > 0.001f && depth < maxDepth) {
+            Vec3 normal = hit.normal;
+            float n1, n2;
+            bool entering = viewDir.dot(normal) < 0;
+            if (entering) {
+                n1 = 1.0f;
+                n2 = hit.material.refractiveIndex;
+            } else {
+                n1 = hit.material.refractiveIndex;
+                n2 = 1.0f;
+                normal = normal * -1.0f;
+            }
+
+            float eta = n1 / n2;
+            float cosI = std::abs(viewDir.dot(normal));
+            Vec3 refractDir = viewDir.refract(normal, eta);
+            bool totalInternalReflection = (refractDir.lengthSquared() < 0.001f);
+
+            node.weight = transparency;
+            node.fresnel = std::fmin(scene.fresnel(cosI, n1, n2), 0.95f);
+            node.tint = hit.material.color;
+            node.kind = totalInternalReflection ? GLASS_TIR : GLASS;
+
+            Ray reflectRay(hit.point + normal * 0.001f, viewDir.reflect(normal));
+            if (scene.stochasticBounces) {
+                // Same pick and roulette as Scene::shadeHit
+                bool reflect = totalInternalReflection || Scene::randomFloat() < node.fresnel;
+                Vec3 tint = reflect ? Vec3(1.0f, 1.0f, 1.0f) : hit.material.color;
+                float next = node.throughput * transparency * std::fmax(tint.x, std::fmax(tint.y, tint.z));
+                Ray bounce = reflect ? reflectRay : Ray(hit.point - normal * 0.001f, refractDir);
+                emitPicked(scene, depth, index, bounce, tint, next, maxDepth);
+                return;
+            }
+            emit(scene, depth, index, 0, reflectRay, maxDepth);
+            if (!totalInternalReflection) {
+                Ray refractRay(hit.point - normal * 0.001f, refractDir);
+                emit(scene, depth, index, 1, refractRay, maxDepth);
+            }
+        } else if (reflectivity > 0.001f && depth < maxDepth) {
+            float cosTheta = std::abs(hit.normal.dot(viewDir * -1.0f));
+            float fresnelFactor = reflectivity + (1.0f - reflectivity) * std::pow(1.0f - cosTheta, 3.0f);
+            node.weight = std::fmin(1.0f, fresnelFactor);
+            node.kind = MIRROR;
+
+            Ray reflectRay(hit.point + hit.normal * 0.001f, viewDir.reflect(hit.normal));
+            if (scene.stochasticBounces) {
+                emitPicked(scene, depth, index, reflectRay, Vec3(1.0f, 1.0f, 1.0f), node.throughput * node.weight,
+                           maxDepth);
+                return;
+            }
+            emit(scene, depth, index, 0, reflectRay, maxDepth);
+        }
+    }
+
+    // Stochastic bounces: queue the one bounce (tinted, by Russian roulette)
+    // that stands in for all of the node's bounces
+    void emitPicked(const Scene& scene, int depth, uint32_t index, const Ray& ray, const Vec3& tint,
+                    float throughput, int maxDepth) {
+        Node& node = levels[depth][index];
+        float scale = Scene::rouletteWeight(throughput);
+        node.kind = PICKED;
+        node.tint = tint;
+        node.fresnel = scale;
+        node.reflected = Vec3(0, 0, 0);
+        if (scale > 0.0f) {
+            emit(scene, depth, index, 0, ray, maxDepth, throughput * scale);
+        }
+    }
+
+    // Queue a bounce, or settle it right away when it is past the depth limit
+    void emit(const Scene& scene, int depth, uint32_t parent, uint8_t slot, const Ray& ray, int maxDepth,
+              float throughput = 1.0f) {
+        if (depth + 1 >= maxDepth) {
+            Node& owner = levels[depth][parent];
+            (slot == 0 ? owner.reflected : owner.refracted) = scene.getBackgroundColor(ray);
+            return;
+        }
+
+        std::vector<Node>& next = levelAt(depth + 1);
+        if (depthCount <= depth + 1) {
+            depthCount = depth + 2;
+            next.clear();
+        }
+        Node child;
+        child.ray = ray;
+        child.parent = parent;
+        child.slot = slot;
+        child.kind = PENDING;
+        child.throughput = throughput;
+        next.push_back(child);
+    }
+
+    // Fill `order` with the level's node indices, if `sort` sorted by direction octant
+    // and then by origin cell along a Morton curve (half-unit cells, 4 bits
+    // per axis, wrapping every 8 units). The 15-bit keys are sorted stably in
+    // two counting passes of 8 and 7 bits; nodes stay where they are, since
+    // copying them costs more than the sort saves.
+    void sortLevel(int depth, bool sort) {
+        std::vector<Node>& level = levels[depth];
+        size_t count = level.size();
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        // Levels can outgrow 17 index bits (2^17 rays); leave those unsorted
+        if (!sort || count >= (size_t(1) << 17)) {
+            return;
+        }
+
+        keys.resize(count);
+        sortedKeys.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const Ray& ray = level[i].ray;
+            uint32_t octant = (ray.direction.x < 0.0f ? 1u : 0u) | (ray.direction.y < 0.0f ? 2u : 0u) |
+                              (ray.direction.z < 0.0f ? 4u : 0u);
+            uint32_t cx = static_cast<uint32_t>(static_cast<int32_t>(std::floor(ray.origin.x * 2.0f))) & 15u;
+            uint32_t cy = static_cast<uint32_t>(static_cast<int32_t>(std::floor(ray.origin.y * 2.0f))) & 15u;
+            uint32_t cz = static_cast<uint32_t>(static_cast<int32_t>(std::floor(ray.origin.z * 2.0f))) & 15u;
+            uint32_t key = (octant << 12) | spread3(cx) | (spread3(cy) << 1) | (spread3(cz) << 2);
+            keys[i] = (key << 17) | static_cast<uint32_t>(i);  // Index in the low bits
+        }
+
+        radixPass(keys, sortedKeys, 17, 8);
+        radixPass(sortedKeys, keys, 25, 7);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = keys[i] & ((1u << 17) - 1);
+        }
+    }
+
+    // Stable counting sort of src into dst on `bits` bits starting at `shift`
+    static void radixPass(const std::vector<uint32_t>& src, std::vector<uint32_t>& dst, int shift, int bits) {
+        uint32_t offsets[256] = {};
+        uint32_t mask = (1u << bits) - 1;
+        for (uint32_t key : src) {
+            ++offsets[(key >> shift) & mask];
+        }
+        uint32_t sum = 0;
+        for (uint32_t& offset : offsets) {
+            uint32_t n = offset;
+            offset = sum;
+            sum += n;
+        }
+        for (uint32_t key : src) {
+            dst[offsets[(key >> shift) & mask]++] = key;
+        }
+    }
+
+    // Insert two zero bits between each of the low 4 bits
+    static uint32_t spread3(uint32_t v) {
+        v = (v | (v << 4)) & 0x0C3u;
+        v = (v | (v << 2)) & 0x249u;
+        return v;
+    }
+
+    // Same blends as Scene::shadeHit once the bounce colors are in
+    static Vec3 resolve(const Node& node) {
+        switch (node.kind) {
+            case RESOLVED:
+                return node.color;
+            case MIRROR:
+                return (node.color * (1.0f - node.weight) + node.reflected * node.weight).clamp();
+            case GLASS_TIR:
+                return (node.color * (1.0f - node.weight) + node.reflected * node.weight).clamp();
+            case PICKED:
+                return Scene::rouletteBlend(node.color * (1.0f - node.weight), node.reflected * node.tint * node.weight,
+                                            node.fresnel);
+            case GLASS: {
+                Vec3 refracted = node.refracted * node.tint;
+                Vec3 transparentColor = node.reflected * node.fresnel + refracted * (1.0f - node.fresnel);
+                return (node.color * (1.0f - node.weight) + transparentColor * node.weight).clamp();
+            }
+            default:
+                return node.color.clamp();
+        }
+    }
+};
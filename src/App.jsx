@@ -46,6 +46,7 @@ function App() {
     maxBounces: 5,
     resolution: 512,
     antiAliasing: 0,  // 0=Off, 1=2x2, 2=4x4
+    stochasticBounces: false,  // Accumulates frames while the view is still
     // Soft shadows
     softShadows: false,
     shadowSamples: 9,
@@ -154,10 +155,14 @@ function App() {
           
           <div className="canvas-area">
             {loading && (
-              <div className="status-card">
-                <div className="spinner" />
-                <p className="status-title">Initializing WebAssembly</p>
-                <p className="status-subtitle">Loading ray tracing engine...</p>
+              <div className="loading-preview">
+                {/* Prebuilt render of the default scene, shown until the engine's first frame */}
+                <img className="scene-preview" src="/default-scene-preview.png" alt="" />
+                <div className="status-card">
+                  <div className="spinner" />
+                  <p className="status-title">Initializing WebAssembly</p>
+                  <p className="status-subtitle">Loading ray tracing engine...</p>
+                </div>
               </div>
             )}
             
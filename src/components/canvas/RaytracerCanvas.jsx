@@ -1,6 +1,31 @@
 import { useRef, useEffect, useCallback, useState } from 'react';
+import { hasBinding } from '../../hooks/useWasm';
 import './RaytracerCanvas.css';
 
+// Frames averaged while the view stays still in stochastic bounce mode
+const MAX_ACCUMULATED_FRAMES = 64;
+
+// Wrap a frame view in place (the WASM heap is fixed, so the view stays
+// valid); putImageData copies it before the next frame
+function wrapPixels(pixels) {
+  return new Uint8ClampedArray(pixels.buffer, pixels.byteOffset, pixels.length);
+}
+
+// Render a full frame. renderFrame() returns a view of the framebuffer;
+// modules built before it only have render(), whose vector is copied out
+function renderPixels(wasmModule, resolution) {
+  if (hasBinding(wasmModule, 'renderFrame')) {
+    return wrapPixels(wasmModule.renderFrame(resolution, resolution));
+  }
+  const pixelVector = wasmModule.render(resolution, resolution);
+  const pixelData = new Uint8ClampedArray(pixelVector.size());
+  for (let i = 0; i < pixelData.length; i++) {
+    pixelData[i] = pixelVector.get(i);
+  }
+  pixelVector.delete();
+  return pixelData;
+}
+
 function RaytracerCanvas({ 
   wasmModule, 
   lights, 
@@ -19,6 +44,8 @@ function RaytracerCanvas({
   const lastMousePos = useRef({ x: 0, y: 0 });
   const renderRequestRef = useRef(null);
   const lastPresetRef = useRef(scenePreset);
+  // Startup timings are logged once, when the first preview level is drawn
+  const firstFrameRef = useRef(true);
 
   // Calculate display size to fill container while maintaining square aspect
   useEffect(() => {
@@ -86,6 +113,14 @@ function RaytracerCanvas({
     wasmModule.updateGroundReflectivity(view.groundReflectivity);
     wasmModule.setMaxReflectionDepth(view.maxBounces);
     wasmModule.setAntiAliasing(view.antiAliasing);
+    // Stochastic bounces only make sense with accumulation; both are missing
+    // from modules built before them
+    const stochastic = view.stochasticBounces && hasBinding(wasmModule, 'setAccumulation');
+    if (hasBinding(wasmModule, 'setAccumulation')) {
+      wasmModule.setStochasticBounces(stochastic);
+      // Restarts the average: something changed if this callback runs
+      wasmModule.setAccumulation(stochastic);
+    }
     
     // Soft shadow settings
     wasmModule.setSoftShadows(view.softShadows);
@@ -95,29 +130,69 @@ function RaytracerCanvas({
       wasmModule.setLightRadius(i, view.lightRadius);
     }
 
-    // Time the render
-    const startTime = performance.now();
-    const pixelVector = wasmModule.render(resolution, resolution);
-    const endTime = performance.now();
-    onRenderTime(endTime - startTime);
-
-    // Copy data from C++ vector
-    const size = pixelVector.size();
-    const pixelData = new Uint8ClampedArray(size);
-    for (let i = 0; i < size; i++) {
-      pixelData[i] = pixelVector.get(i);
-    }
-    pixelVector.delete();
-
-    // Draw to canvas
-    const imageData = new ImageData(pixelData, resolution, resolution);
-    
     if (canvas.width !== resolution) {
       canvas.width = resolution;
       canvas.height = resolution;
     }
-    
-    ctx.putImageData(imageData, 0, 0);
+
+    const draw = (pixelData) => {
+      ctx.putImageData(new ImageData(pixelData, resolution, resolution), 0, 0);
+    };
+
+    const markFirstFrame = () => {
+      if (!firstFrameRef.current) return;
+      firstFrameRef.current = false;
+      performance.mark('raytracer:first-frame');
+      const ready = performance.getEntriesByName('raytracer:wasm-ready')[0];
+      console.info(
+        `Ray tracer startup: module ready at ${Math.round(ready ? ready.startTime : 0)} ms, ` +
+        `first frame at ${Math.round(performance.now())} ms`
+      );
+    };
+
+    // Stochastic bounces: keep adding frames to the average until it settles
+    const accumulate = () => {
+      draw(renderPixels(wasmModule, resolution));
+      if (wasmModule.getAccumulatedFrames() < MAX_ACCUMULATED_FRAMES) {
+        renderRequestRef.current = requestAnimationFrame(accumulate);
+      }
+    };
+
+    // Modules built before the progressive preview draw one full frame
+    if (!hasBinding(wasmModule, 'beginProgressiveFrame')) {
+      const startTime = performance.now();
+      const pixelData = renderPixels(wasmModule, resolution);
+      onRenderTime(performance.now() - startTime);
+      draw(pixelData);
+      markFirstFrame();
+      return;
+    }
+
+    // Coarse-to-fine: a blocky 1/8 preview is drawn right away and refined
+    // (1/4, 1/2, full) on the following animation frames. Any state change
+    // cancels the pending level and restarts from the coarsest one.
+    wasmModule.beginProgressiveFrame(resolution, resolution);
+    let traceTime = 0;
+
+    const drawLevel = () => {
+      const startTime = performance.now();
+      const pixels = wasmModule.renderNextLevel();
+      traceTime += performance.now() - startTime;
+      draw(wrapPixels(pixels));
+      markFirstFrame();
+
+      if (wasmModule.getProgressiveStride() > 1) {
+        renderRequestRef.current = requestAnimationFrame(drawLevel);
+      } else {
+        // Total trace time of the frame, excluding the gaps between levels
+        onRenderTime(traceTime);
+        if (stochastic) {
+          renderRequestRef.current = requestAnimationFrame(accumulate);
+        }
+      }
+    };
+
+    drawLevel();
   }, [wasmModule, lights, material, camera, view, scenePreset, onRenderTime]);
 
   // Debounced render
@@ -235,7 +310,7 @@ function RaytracerCanvas({
         onTouchCancel={handleTouchEnd}
       />
       <div className="canvas-badge top-left">
-        {view.resolution}² • {lights.length}💡{view.antiAliasing > 0 && ` • AA`}{view.softShadows && ` • Soft`}
+        {view.resolution}² • {lights.length}💡{view.antiAliasing > 0 && ` • AA`}{view.softShadows && ` • Soft`}{view.stochasticBounces && wasmModule && hasBinding(wasmModule, 'setAccumulation') && ` • Stochastic`}
       </div>
       <div className="canvas-badge bottom-right">
         {isMobile ? 'Touch to orbit' : 'Drag to orbit • Scroll to zoom'}
@@ -86,6 +86,15 @@ function ViewControls({ view, onChange, disabled }) {
           disabled={disabled}
           formatValue={(v) => v.toFixed(0)}
         />
+
+        {/* One Fresnel-picked bounce per glass hit; frames are averaged */}
+        <Toggle
+          id="stochastic-bounces"
+          label="Stochastic Bounces"
+          checked={view.stochasticBounces}
+          onChange={(v) => handleChange('stochasticBounces', v)}
+          disabled={disabled}
+        />
       </div>
 
       <div className="control-divider" />
@@ -1,31 +1,117 @@
 import { useState, useEffect } from 'react';
 
+// Module variants emitted by cpp/build.sh; only the ones that were built are
+// bundled, so a missing variant simply falls back to the baseline module
+const variantModules = import.meta.glob('../wasm/raytracer*.js');
+
+// Largest resolution the view controls offer; the render arena is sized for it
+const MAX_RESOLUTION = 1024;
+
+const VARIANT_FILES = {
+  simd: '../wasm/raytracer-simd.js',
+  baseline: '../wasm/raytracer.js',
+  small: '../wasm/raytracer-small.js',
+};
+
+// Smallest module using a SIMD128 instruction (i8x16.splat, i8x16.popcnt)
+const SIMD_PROBE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0,
+  65, 0, 253, 15, 253, 98, 11,
+]);
+
+/**
+ * The committed src/wasm module can predate bindings added since it was
+ * built, so newer ones are feature-detected and the older path kept
+ */
+export function hasBinding(module, name) {
+  return typeof module[name] === 'function';
+}
+
+export function supportsWasmSimd() {
+  try {
+    return WebAssembly.validate(SIMD_PROBE);
+  } catch {
+    return false;
+  }
+}
+
+/**
+ * Variants to try, fastest first. `?wasm=simd|baseline|small` in the page URL
+ * forces one (useful for comparing builds).
+ */
+function variantOrder() {
+  const forced = new URLSearchParams(window.location.search).get('wasm');
+  if (forced && VARIANT_FILES[forced]) {
+    return [forced, 'baseline'];
+  }
+  return supportsWasmSimd() ? ['simd', 'baseline'] : ['baseline'];
+}
+
+/**
+ * Fetch, compile and instantiate the best available variant. Emscripten
+ * compiles the .wasm while it downloads (instantiateStreaming).
+ */
+async function loadModule() {
+  const available = variantOrder().filter((name) => variantModules[VARIANT_FILES[name]]);
+  if (available.length === 0) {
+    throw new Error('No WebAssembly module found (run npm run build:wasm)');
+  }
+
+  for (let i = 0; i < available.length; i++) {
+    try {
+      const createModule = (await variantModules[VARIANT_FILES[available[i]]]()).default;
+      const module = await createModule();
+      if (hasBinding(module, 'setMaxResolution')) {
+        module.setMaxResolution(MAX_RESOLUTION, MAX_RESOLUTION);
+      }
+      performance.mark('raytracer:wasm-ready');
+      return { module, variant: available[i] };
+    } catch (err) {
+      if (i === available.length - 1) throw err;
+      console.warn(`WASM variant "${available[i]}" failed, trying the next one:`, err);
+    }
+  }
+}
+
+// Started when this file is first imported, before React mounts, so the
+// download overlaps the app's own startup
+const modulePromise = loadModule();
+// Errors are reported through the hook
+modulePromise.catch(() => {});
+
 /**
  * Custom hook for loading and managing the WebAssembly module
  */
 export function useWasm() {
   const [wasmModule, setWasmModule] = useState(null);
+  const [variant, setVariant] = useState(null);
   const [loading, setLoading] = useState(true);
   const [error, setError] = useState(null);
 
   useEffect(() => {
-    async function loadWasm() {
-      try {
-        const createModule = (await import('../wasm/raytracer.js')).default;
-        const module = await createModule();
-        setWasmModule(module);
+    let cancelled = false;
+
+    modulePromise.then(
+      (loaded) => {
+        if (cancelled) return;
+        setWasmModule(loaded.module);
+        setVariant(loaded.variant);
         setLoading(false);
-      } catch (err) {
+      },
+      (err) => {
+        if (cancelled) return;
         console.error('Failed to load WASM module:', err);
         setError(err.message);
         setLoading(false);
       }
-    }
+    );
 
-    loadWasm();
+    return () => {
+      cancelled = true;
+    };
   }, []);
 
-  return { wasmModule, loading, error };
+  return { wasmModule, variant, loading, error };
 }
 
 export default useWasm;